@@ -34,6 +34,7 @@ class TypeWalk {
         void visitIndex(std::shared_ptr<AST> t);
         void visitFilter(std::shared_ptr<AST> t);
         void visitGenerator(std::shared_ptr<AST> t);
+        void inferDomainVariableType(std::shared_ptr<AST> t);
         void visitCast(std::shared_ptr<AST> t);
         void visitExpression(std::shared_ptr<AST> t);
         void visitTupleAccess(std::shared_ptr<AST> t);
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+
+namespace gazprea {
+
+// the kind of file gazc writes to the output path
+enum class EmitKind {
+    LLVM_IR,     // textual .ll for lli (default)
+    BITCODE,     // .bc
+    ASSEMBLY,    // native .s
+    OBJECT,      // native .o
+    EXECUTABLE,  // native object linked against the static gazrt
+};
+
+/**
+ * Options from the gazc command line that change how the module is generated and written
+ */
+struct CodegenOptions {
+    unsigned optLevel = 0;  // -O0 to -O3
+    EmitKind emitKind = EmitKind::LLVM_IR;  // --emit=ll|bc|asm|obj|exe
+    std::string runtimeLibraryPath;  // --gazrt=<path to libgazrt.a>, used by --emit=exe
+    bool runJIT = false;  // --run: execute main in-process instead of writing an output file
+    std::string runtimeSharedLibraryPath;  // --gazrt-shared=<path to libgazrt.so>, loaded into gazc by --run
+    bool linkRuntimeBitcode = false;  // --link-gazrt-bc: link the runtime into the module before optimizing
+    std::string runtimeBitcodePath;  // --gazrt-bc=<path to gazrt.bc>
+    bool parallelComprehensions = false;  // --parallel-comprehensions: run pure generator/filter bodies on the gazrt thread pool
+};
+
+}
@@ -7,7 +7,31 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Verifier.h"
 #include "llvm/IR/NoFolder.h"
+#include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/Verifier.h" 
+#include "llvm/IR/LegacyPassManager.h"
+#include "llvm/Transforms/IPO.h"
+#include "llvm/Transforms/IPO/Internalize.h"
+#include "llvm/Transforms/IPO/PassManagerBuilder.h"
+#include "llvm/Bitcode/BitcodeReader.h"
+#include "llvm/Bitcode/BitcodeWriter.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Linker/Linker.h"
+#include "llvm/ExecutionEngine/Orc/ExecutionUtils.h"
+#include "llvm/ExecutionEngine/Orc/LLJIT.h"
+#include "llvm/MC/SubtargetFeature.h"
+#include "llvm/Support/DynamicLibrary.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Host.h"
+#include "llvm/Support/Program.h"
+#include "llvm/Support/TargetSelect.h"
+#include "llvm/Target/TargetMachine.h"
+#include "llvm/Target/TargetOptions.h"
+#if LLVM_VERSION_MAJOR >= 14
+#include "llvm/MC/TargetRegistry.h"
+#else
+#include "llvm/Support/TargetRegistry.h"
+#endif
 
 #include "llvm/Support/raw_os_ostream.h"
 
@@ -15,21 +39,31 @@
 #include "VariableSymbol.h"
 #include "LLVMIRBranch.h"
 #include "LLVMIRFunction.h"
+#include "CodegenOptions.h"
 
 #include "MatrixType.h"
 #include "TypedefTypeSymbol.h"
 #include "LocalScope.h"
 #include "TypePromote.h"
 
+#include <functional>
+#include <map>
+#include <set>
+
 namespace gazprea {
 
 class LLVMGen {
     public:
         std::shared_ptr<SymbolTable> symtab;
-        llvm::LLVMContext globalCtx;
+        // own the context and the module so runWithJIT can move them into the JIT, mod is unusable after that
+        llvm::orc::ThreadSafeContext threadSafeCtx;
+        std::unique_ptr<llvm::Module> ownedMod;
+        llvm::LLVMContext &globalCtx;
+        // no folding while generating, -O0 keeps every instruction and the -O1+ pipeline folds constants itself
         llvm::IRBuilder<llvm::NoFolder> ir;
-        llvm::Module mod;
+        llvm::Module &mod;
         std::string outfile;
+        CodegenOptions options;
 
         llvm::StructType *runtimeTypeTy;
         llvm::StructType *runtimeVariableTy;
@@ -52,7 +86,13 @@ class LLVMGen {
 
         bool isExpressionToReplaceIdentityNull = false;
 
-        LLVMGen(std::shared_ptr<SymbolTable> symtab, std::shared_ptr<TypePromote> tp, std::string& outfile);
+        // native values that generateUnboxedScalar uses for these symbols instead of reading their runtime variables
+        std::map<std::shared_ptr<Symbol>, llvm::Value*> unboxedSymbolValues;
+        bool isGeneratingOutlinedTask = false;  // calls box their arguments instead of visiting them while true
+        std::map<std::shared_ptr<Symbol>, bool> threadSafeFunctions;  // memo of isThreadSafeFunction
+        static constexpr int64_t PARALLEL_COMPREHENSION_GRAIN = 4096;  // domain indices per thread pool chunk
+
+        LLVMGen(std::shared_ptr<SymbolTable> symtab, std::shared_ptr<TypePromote> tp, std::string& outfile, const CodegenOptions& options);
         ~LLVMGen();
 
         //AST Walker
@@ -74,6 +114,8 @@ class LLVMGen {
         void visitCharacterAtom(std::shared_ptr<AST> t);
         void visitIntegerAtom(std::shared_ptr<AST> t);
         void visitRealAtom(std::shared_ptr<AST> t);
+        int32_t parseIntegerLiteral(std::shared_ptr<AST> t);
+        float parseRealLiteral(std::shared_ptr<AST> t);
         void visitIdentityAtom(std::shared_ptr<AST> t);
         void visitNullAtom(std::shared_ptr<AST> t);
         void visitStringLiteral(std::shared_ptr<AST> t);
@@ -118,6 +160,12 @@ class LLVMGen {
 
         //Helper Methods 
         void Print();
+        bool linkRuntimeBitcode();
+        void optimizeModule();
+        std::unique_ptr<llvm::TargetMachine> createTargetMachine();
+        bool emitNativeFile(llvm::TargetMachine *targetMachine, const std::string &path, llvm::CodeGenFileType fileType);
+        bool linkExecutable(const std::string &objectFile);
+        int runWithJIT();
         void initializeGlobalVariables();
         void freeGlobalVariables();
         void freeAllVariablesDeclaredInBlockScope(std::shared_ptr<LocalScope> scope);
@@ -125,14 +173,51 @@ class LLVMGen {
         void freeSubroutineParameters(std::shared_ptr<SubroutineSymbol> subroutineSymbol);
         void freeExpressionIfNecessary(std::shared_ptr<AST> t);
         void freeExprAtomIfNecessary(std::shared_ptr<AST> t);
+        bool isTemporaryExpression(std::shared_ptr<AST> t);
+        void initializeFromDeclarationThenFreeExpression(llvm::Value* variable, llvm::Value* type, std::shared_ptr<AST> t);
+        llvm::Value* moveOrCopyExpression(std::shared_ptr<AST> t);
         llvm::Value* getStack();
         std::string unescapeString(const std::string &s);
 
+        //Unboxed scalar expression Helper Methods
+        int getUnboxedScalarTypeId(std::shared_ptr<AST> t);
+        int getUnboxedBinaryOperationTypeId(std::shared_ptr<AST> t, int &operandTypeId);
+        int getUnboxedUnaryOperationTypeId(std::shared_ptr<AST> t);
+        llvm::Value* generateUnboxedScalar(std::shared_ptr<AST> t, int typeId);
+        llvm::Value* generateUnboxedBinaryOperation(std::shared_ptr<AST> t);
+        llvm::Value* generateUnboxedUnaryOperation(std::shared_ptr<AST> t);
+        llvm::Value* boxUnboxedScalar(llvm::Value* value, int typeId);
+        llvm::Value* unboxScalarVariable(llvm::Value* variable, int typeId);
+        llvm::Value* generateUnboxedCall(std::shared_ptr<AST> t);
+        int getRuntimeElementTypeId(int typeId);
+        llvm::Type* getUnboxedElementStorageType(int typeId);
+        llvm::Value* getUnboxedArrayData(llvm::Value* arrayVariable, int typeId);
+        void storeUnboxedArrayElement(llvm::Value* arrayData, llvm::Value* index, llvm::Value* value, int typeId);
+        void createDivisionByZeroCheck(llvm::Value* divisor, const std::string& errorMsg);
+
         //Iterator loop Generator & Filter Helper Methods
         llvm::Value* createBranchCondition(llvm::Value* currentIndex, llvm::Value* domainLength);
+        llvm::AllocaInst* createEntryBlockAlloca(llvm::Type* type);
+        bool isBuiltInCall(std::shared_ptr<AST> t, const std::string &name);
+        bool isLazyIntegerSequence(std::shared_ptr<AST> t);
+        void generateLazyIntegerSequence(std::shared_ptr<AST> t, llvm::Value* &head, llvm::Value* &step, llvm::Value* &length);
         void initializeVariableSymbol(std::shared_ptr<AST> t, llvm::Value* domainVariable);
         void incrementIndex(llvm::Value* index, unsigned int increment);
         void initializeDomainVariable(llvm::Value* domainVariable, llvm::Value* domainArray, llvm::Value* index);
+
+        //Parallel comprehension Helper Methods
+        bool collectOutlinableIdentifiers(std::shared_ptr<AST> t, std::vector<std::shared_ptr<AST>> &identifiers);
+        bool isThreadSafeFunction(std::shared_ptr<Symbol> subroutineSymbol);
+        bool isThreadSafeSubtree(std::shared_ptr<AST> t, std::set<std::shared_ptr<Symbol>> &visitedFunctions);
+        bool isParallelComprehension(const std::vector<std::shared_ptr<AST>> &bodies, std::vector<std::shared_ptr<AST>> &identifiers);
+        llvm::Value* getParallelDomainData(std::shared_ptr<Symbol> domainSymbol, llvm::Value* runtimeDomainArray,
+                                           const std::vector<std::shared_ptr<AST>> &identifiers, int &domainTypeId);
+        llvm::Value* loadUnboxedArrayElement(llvm::Value* arrayData, llvm::Value* index, int typeId);
+        void createNativeLoop(llvm::Value* begin, llvm::Value* end, const std::function<void(llvm::Value*)> &emitBody);
+        llvm::Function* createOutlinedTask(const std::string &name, const std::vector<llvm::Value*> &captures, llvm::Value* &taskArg,
+                                           const std::function<void(const std::vector<llvm::Value*>&, llvm::Value*, llvm::Value*)> &emitRange);
+        void captureOutlinedIdentifiers(const std::vector<std::shared_ptr<AST>> &identifiers, const std::vector<std::shared_ptr<Symbol>> &domainSymbols,
+                                        std::vector<llvm::Value*> &captures, std::vector<std::shared_ptr<Symbol>> &capturedSymbols);
 };
 
 }
\ No newline at end of file
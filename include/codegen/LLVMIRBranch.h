@@ -2,9 +2,9 @@
 
 #include <iostream>
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/NoFolder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Function.h"
-#include "llvm/IR/NoFolder.h"
 
 #include <vector>
 
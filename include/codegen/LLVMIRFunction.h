@@ -1,9 +1,9 @@
 #pragma once
 
 #include "llvm/IR/IRBuilder.h"
+#include "llvm/IR/NoFolder.h"
 #include "llvm/IR/LLVMContext.h"
 #include "llvm/IR/Function.h"
-#include "llvm/IR/NoFolder.h"
 #include <map>
 #include "GazpreaParser.h"
 
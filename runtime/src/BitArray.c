@@ -0,0 +1,36 @@
+#include <stdlib.h>
+#include "BitArray.h"
+
+uint64_t bitArrayTailMask(int64_t nBits) {
+    int64_t rest = nBits % BIT_ARRAY_WORD_BITS;
+    return rest == 0 ? ~(uint64_t)0 : ((uint64_t)1 << rest) - 1;
+}
+
+int64_t bitArrayNumWords(int64_t nBits) {
+    return (nBits + BIT_ARRAY_WORD_BITS - 1) / BIT_ARRAY_WORD_BITS;
+}
+
+uint64_t *bitArrayMalloc(int64_t nBits) {
+    return calloc(bitArrayNumWords(nBits) + 1, sizeof(uint64_t));  // never a zero sized allocation
+}
+
+void bitArrayFree(uint64_t *this) {
+    free(this);
+}
+
+void bitArraySet(uint64_t *this, int64_t idx, bool val) {
+    uint64_t bit = (uint64_t)1 << (idx % BIT_ARRAY_WORD_BITS);
+    if (val)
+        this[idx / BIT_ARRAY_WORD_BITS] |= bit;
+    else
+        this[idx / BIT_ARRAY_WORD_BITS] &= ~bit;
+}
+
+int64_t bitArrayPopCount(const uint64_t *this, int64_t nBits) {
+    int64_t nWords = bitArrayNumWords(nBits);
+    int64_t count = 0;
+    for (int64_t w = 0; w < nWords; w++)
+        count += __builtin_popcountll(this[w]);
+    return count;
+}
+
@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * Bit-packed boolean masks, 64 booleans per word
+ * Bit i of an array is bit i % 64 of word i / 64; bits past the length in the last word are kept zero so popcounts
+ * never need to mask them
+ * Used for the accept matrix of a filter, which only the runtime reads; boolean vectors and matrices themselves keep
+ * one element per boolean because the rest of the runtime hands out pointers to single elements
+ */
+
+#include <stdint.h>
+#include "Bool.h"
+
+#define BIT_ARRAY_WORD_BITS 64
+
+int64_t bitArrayNumWords(int64_t nBits);
+uint64_t bitArrayTailMask(int64_t nBits);  // the bits of the last word that are inside the array
+uint64_t *bitArrayMalloc(int64_t nBits);  // all bits cleared
+void bitArrayFree(uint64_t *this);
+
+void bitArraySet(uint64_t *this, int64_t idx, bool val);
+int64_t bitArrayPopCount(const uint64_t *this, int64_t nBits);
@@ -33,8 +33,6 @@ Variable *BuiltInReverse(Variable *vec) {
     } else {  // vec is a 1d vector or integer interval
         switch (vec->m_type->m_typeId) {
             case TYPEID_NDARRAY: {
-                ArrayType *vecCTI = vec->m_type->m_compoundTypeInfo;
-                ElementTypeID eid = vecCTI->m_elementTypeID;
                 Variable *pop = variableConvertLiteralAndRefToConcreteArray(vec);
                 pop = pop ? pop : vec;
 
@@ -42,8 +40,7 @@ Variable *BuiltInReverse(Variable *vec) {
                 int64_t len = variableGetLength(pop);
                 for (int64_t i = 0; i < len; i++) {
                     void *src = variableNDArrayGet(pop, i);
-                    void *target = variableNDArrayGet(result, len - i - 1);
-                    elementAssign(eid, target, src);
+                    variableNDArraySet(result, len - i - 1, src);  // result shares pop's buffer until the first write
                 }
 
                 if (pop != vec) {
@@ -1,4 +1,5 @@
-#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include "FreeList.h"
 
 FreeList *freeListAppend(FreeList *prev, void *data) {
@@ -17,4 +18,90 @@ void freeListFreeAll(FreeList *this, void freeFunc(void *)) {
         freeFunc(this->m_data);
         free(this);
     }
-}
\ No newline at end of file
+}
+
+///------------------------------SIZE CLASS POOL---------------------------------------------------------------
+
+// each thread has its own pool, a block malloc'd on one thread and freed on another joins the freeing thread's pool
+static _Thread_local FreeListPoolClass freeListPoolClasses[FREE_LIST_POOL_NUM_CLASSES];
+static _Thread_local int64_t freeListPoolNumLargeMallocs = 0;
+static _Thread_local int freeListPoolInitialized = 0;
+static _Thread_local int freeListPoolDisabled = 0;
+static int freeListPoolStatsRegistered = 0;
+
+void freeListPoolInit() {
+    freeListPoolInitialized = 1;
+    // the first thread to use a pool is the main thread, whose pool is the one reported at exit
+    if (!freeListPoolStatsRegistered && getenv("GAZRT_POOL_STATS") != NULL) {
+        freeListPoolStatsRegistered = 1;
+        atexit(freeListPoolPrintStats);
+    }
+}
+
+// smallest class that fits size, or -1 if the size is larger than every class
+int freeListPoolClassFromRequest(int64_t size) {
+    int cls = 0;
+    while (cls < FREE_LIST_POOL_NUM_CLASSES && ((int64_t)1 << (cls + FREE_LIST_POOL_MIN_CLASS_SHIFT)) < size)
+        cls++;
+    return cls < FREE_LIST_POOL_NUM_CLASSES ? cls : -1;
+}
+
+void freeListPoolDisableOnThisThread() {
+    if (!freeListPoolInitialized)
+        freeListPoolInit();
+    freeListPoolDisabled = 1;
+}
+
+void *freeListPoolMalloc(int64_t size) {
+    if (!freeListPoolInitialized)
+        freeListPoolInit();
+    int cls = freeListPoolClassFromRequest(size);
+    FreeListPoolHeader *header;
+    if (cls < 0) {
+        freeListPoolNumLargeMallocs++;
+        header = malloc(sizeof(FreeListPoolHeader) + size);
+    } else if (freeListPoolClasses[cls].m_head != NULL) {
+        FreeListPoolClass *pool = &freeListPoolClasses[cls];
+        header = (FreeListPoolHeader *)pool->m_head - 1;
+        pool->m_head = pool->m_head->m_next;
+        pool->m_numBlocks--;
+        pool->m_hits++;
+    } else {
+        freeListPoolClasses[cls].m_misses++;
+        header = malloc(sizeof(FreeListPoolHeader) + ((int64_t)1 << (cls + FREE_LIST_POOL_MIN_CLASS_SHIFT)));
+    }
+    header->m_class = cls;
+    return header + 1;
+}
+
+void freeListPoolFree(void *block) {
+    if (block == NULL)
+        return;
+    FreeListPoolHeader *header = (FreeListPoolHeader *)block - 1;
+    int cls = (int)header->m_class;
+    if (cls < 0 || freeListPoolDisabled || freeListPoolClasses[cls].m_numBlocks >= FREE_LIST_POOL_MAX_BLOCKS_PER_CLASS) {
+        if (cls >= 0)
+            freeListPoolClasses[cls].m_released++;
+        free(header);
+        return;
+    }
+    FreeListPoolClass *pool = &freeListPoolClasses[cls];
+    FreeList *node = block;
+    node->m_next = pool->m_head;
+    pool->m_head = node;
+    pool->m_numBlocks++;
+}
+
+void freeListPoolPrintStats() {
+    fprintf(stderr, "gazrt pool stats (class bytes: hits / misses, hit rate, released)\n");
+    for (int cls = 0; cls < FREE_LIST_POOL_NUM_CLASSES; cls++) {
+        FreeListPoolClass *pool = &freeListPoolClasses[cls];
+        int64_t total = pool->m_hits + pool->m_misses;
+        if (total == 0)
+            continue;
+        fprintf(stderr, "%6lld: %lld / %lld, %.2f%%, %lld\n", (long long)1 << (cls + FREE_LIST_POOL_MIN_CLASS_SHIFT),
+                (long long)pool->m_hits, (long long)pool->m_misses, 100.0 * (double)pool->m_hits / (double)total,
+                (long long)pool->m_released);
+    }
+    fprintf(stderr, " large: %lld mallocs\n", (long long)freeListPoolNumLargeMallocs);
+}
@@ -8,4 +8,39 @@ typedef struct struct_gazprea_free_list {
 } FreeList;
 
 FreeList *freeListAppend(FreeList *prev, void *data);
-void freeListFreeAll(FreeList *this, void freeFunc(void *));
\ No newline at end of file
+void freeListFreeAll(FreeList *this, void freeFunc(void *));
+
+///------------------------------SIZE CLASS POOL---------------------------------------------------------------
+
+/**
+ * A free list per power of two size class that backs the element buffers of NDArray.c
+ * Every block starts with a small header holding its size class, so blocks must be allocated with
+ * freeListPoolMalloc() and released with freeListPoolFree(), never with plain malloc()/free()
+ * The pool is thread local so runtime kernels may allocate from worker threads without locking; thread pool workers
+ * live until the process exits and would never drain a pool, so they bypass it and free their blocks right away
+ * Set the environment variable GAZRT_POOL_STATS to print the hit rate of each size class of the main thread at exit
+ */
+#include <stdint.h>
+
+#define FREE_LIST_POOL_MIN_CLASS_SHIFT 4          // the smallest class holds 16 byte blocks
+#define FREE_LIST_POOL_NUM_CLASSES 9              // 16 bytes to 4KiB, larger buffers go straight to malloc()
+#define FREE_LIST_POOL_MAX_BLOCKS_PER_CLASS 1024  // cached blocks beyond this are freed
+
+typedef struct struct_gazprea_free_list_pool_class {
+    FreeList *m_head;  // the free blocks themselves are the list nodes, only m_next is used
+    int64_t m_numBlocks;
+    int64_t m_hits;
+    int64_t m_misses;
+    int64_t m_released;  // freed while the class was full
+} FreeListPoolClass;
+
+// in front of every block, 16 bytes so the block keeps the alignment malloc() gives
+typedef struct struct_gazprea_free_list_pool_header {
+    int64_t m_class;  // -1 for blocks larger than every class
+    int64_t m_padding;
+} FreeListPoolHeader;
+
+void *freeListPoolMalloc(int64_t size);
+void freeListPoolFree(void *block);
+void freeListPoolDisableOnThisThread();
+void freeListPoolPrintStats();
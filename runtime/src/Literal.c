@@ -1,10 +1,12 @@
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
 #include "Literal.h"
 #include "NDArray.h"
 #include "RuntimeErrors.h"
 #include "VariableStdio.h"
 #include "NDArrayVariable.h"
+#include "BitArray.h"
 
 ///------------------------------TYPE---------------------------------------------------------------
 
@@ -173,6 +175,42 @@ void variableInitFromMatrixLiteralHelper(Variable *this, int64_t nVars, Variable
 #endif
 }
 
+// returns the element type shared by all scalar vars, or ELEMENT_MIXED if they differ or are not basic scalars
+ElementTypeID vectorLiteralGetPackedElementType(int64_t nVars, Variable **vars) {
+    ElementTypeID packedID = ELEMENT_MIXED;
+    for (int64_t i = 0; i < nVars; i++) {
+        Type *curType = vars[i]->m_type;
+        if (!typeIsScalarBasic(curType))
+            return ELEMENT_MIXED;
+        ElementTypeID eid = ((ArrayType *) curType->m_compoundTypeInfo)->m_elementTypeID;
+        if (i == 0)
+            packedID = eid;
+        else if (eid != packedID)
+            return ELEMENT_MIXED;
+    }
+    return packedID;
+}
+
+void variableInitFromPackedArrayLiteral(Variable *this, ElementTypeID eid, int8_t nDim, int64_t *dims) {
+    this->m_type = typeMalloc();
+    typeInitFromArrayType(this->m_type, false, eid, nDim, dims);
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    CTI->m_isLiteral = true;
+    this->m_data = arrayMallocFromNull(eid, arrayTypeGetTotalLength(CTI));
+    variableAttrInitHelper(this, -1, this->m_data, false);
+#ifdef DEBUG_PRINT
+    variableInitDebugPrint(this, "from packed array literal");
+#endif
+}
+
+void variableInitFromPackedVectorLiteral(Variable *this, ElementTypeID eid, int64_t nVars, Variable **vars) {
+    int64_t dims[1] = {nVars};
+    variableInitFromPackedArrayLiteral(this, eid, 1, dims);
+    for (int64_t i = 0; i < nVars; i++) {
+        elementAssign(eid, arrayGetElementPtrAtIndex(eid, this->m_data, i), vars[i]->m_data);
+    }
+}
+
 void variableInitFromVectorLiteral(Variable *this, int64_t nVars, Variable **vars) {
     // one pass to check if the result is a vector or a matrix, another to convert it into mixed array
 
@@ -217,11 +255,15 @@ void variableInitFromVectorLiteral(Variable *this, int64_t nVars, Variable **var
         }
     }
 
+    ElementTypeID packedID;
     if (nVars == 0) {  // empty array
         variableInitFromEmptyArray(this);
     } else if (isMatrix) {
         // matrix literal
         variableInitFromMatrixLiteralHelper(this, nVars, modifiedVars, longestLen);
+    } else if ((packedID = vectorLiteralGetPackedElementType(nVars, modifiedVars)) != ELEMENT_MIXED) {
+        // vector literal with a single element type, no need to box each element
+        variableInitFromPackedVectorLiteral(this, packedID, nVars, modifiedVars);
     } else {
         // vector literal
         this->m_type = typeMalloc();
@@ -348,49 +390,88 @@ void variableInitFromGeneratorArray(Variable *this, int64_t nVars, Variable **va
     variableDestructThenFreeImpl(literal);
 }
 
-void variableInitFromFilterArray(Variable *this, int64_t nFilter, Variable *domainExpr, bool *accept) {
+void variableInitFromTypedGeneratorVector(Variable *this, ElementTypeID eid, int64_t length) {
+    if (length == 0) {
+        variableInitFromEmptyArray(this);
+        return;
+    }
+    int64_t dims[1] = {length};
+    variableInitFromPackedArrayLiteral(this, eid, 1, dims);
+}
+
+void variableInitFromTypedGeneratorMatrix(Variable *this, ElementTypeID eid, int64_t nRow, int64_t nCol) {
+    if (nRow == 0) {
+        variableInitFromEmptyArray(this);
+        return;
+    }
+    int64_t dims[2] = {nRow, nCol};
+    variableInitFromPackedArrayLiteral(this, eid, 2, dims);
+}
+
+// copy every element of src to the end of each bucket it falls into, one 64 element word of the accept matrix at a time
+// an element is in bucket i if bit j of row i is set, and in bucket nFilter if no filter accepts it
+#define FILTER_SCATTER(ctype, buckets, filled, src, accept, rowWords, nFilter, domainSize) do { \
+    int64_t nWords = bitArrayNumWords(domainSize); \
+    for (int64_t w = 0; w < nWords; w++) { \
+        const ctype *block = (const ctype *)(src) + w * BIT_ARRAY_WORD_BITS; \
+        uint64_t rejected = w == nWords - 1 ? bitArrayTailMask(domainSize) : ~(uint64_t)0; \
+        for (int64_t i = 0; i < (nFilter); i++) { \
+            uint64_t bits = (accept)[i * (rowWords) + w]; \
+            rejected &= ~bits; \
+            for (; bits != 0; bits &= bits - 1) \
+                ((ctype *)(buckets)[i])[(filled)[i]++] = block[__builtin_ctzll(bits)]; \
+        } \
+        for (; rejected != 0; rejected &= rejected - 1) \
+            ((ctype *)(buckets)[nFilter])[(filled)[nFilter]++] = block[__builtin_ctzll(rejected)]; \
+    } \
+} while (0)
+
+void variableInitFromFilterArray(Variable *this, int64_t nFilter, Variable *domainExpr, uint64_t *accept) {
     int64_t domainSize = variableGetLength(domainExpr);
     ArrayType *domainCTI = domainExpr->m_type->m_compoundTypeInfo;
     ElementTypeID eid = domainCTI->m_elementTypeID;
     int64_t elementSize = elementGetSize(eid);
-    char *resultBuffer = arrayMallocFromNull(eid, domainSize);
 
+    // a reference domain is gathered into a contiguous buffer first
+    char *domainData = domainExpr->m_data;
+    char *gathered = NULL;
+    if (domainCTI->m_isRef) {
+        gathered = arrayMallocFromNull(eid, domainSize);
+        for (int64_t j = 0; j < domainSize; j++)
+            elementAssign(eid, gathered + j * elementSize, variableNDArrayGet(domainExpr, j));
+        domainData = gathered;
+    }
+
+    // the popcount of row i is the size of bucket i, the elements of no row make up the last bucket
+    int64_t rowWords = bitArrayNumWords(acceptMatrixRowLength(domainSize));
+    int64_t nRejected = domainSize;
+    for (int64_t w = 0; w < bitArrayNumWords(domainSize); w++) {
+        uint64_t acceptedBits = 0;
+        for (int64_t i = 0; i < nFilter; i++)
+            acceptedBits |= accept[i * rowWords + w];
+        nRejected -= __builtin_popcountll(acceptedBits);
+    }
+
+    // the buckets are the result buffers themselves, so each element is copied once into every bucket it falls into
     Variable **vars = variableArrayMalloc(nFilter + 1);
-    for (int64_t i = 0; i < nFilter; i++) {
-        int64_t k = 0;
-        for (int64_t j = 0; j < domainSize; j++) {
-            if (accept[i * domainSize + j]) {
-                void *ptr = variableNDArrayGet(domainExpr, j);
-                elementAssign(eid, resultBuffer + k * elementSize, ptr);
-                k += 1;
-            }
-        }
-        int64_t dims[1] = {k};
+    void **buckets = malloc((nFilter + 1) * sizeof(void *));
+    int64_t *filled = calloc(nFilter + 1, sizeof(int64_t));
+    for (int64_t i = 0; i <= nFilter; i++) {
+        int64_t dims[1] = {i < nFilter ? bitArrayPopCount(accept + i * rowWords, domainSize) : nRejected};
         vars[i] = variableMalloc();
-        variableInitFromNDArray(vars[i], false, eid, 1, dims, resultBuffer, false);
+        variableInitFromNDArray(vars[i], false, eid, 1, dims, NULL, false);
+        buckets[i] = vars[i]->m_data;
     }
-    {  // the last variable
-        int64_t k = 0;
-        for (int64_t i = 0; i < domainSize; i++) {
-            bool hasBeenAccepted = false;
-            for (int64_t j = 0; j < nFilter; j++) {
-                if (accept[j * domainSize + i]) {
-                    hasBeenAccepted = true;
-                    break;
-                }
-            }
-            if (!hasBeenAccepted) {
-                void *ptr = variableNDArrayGet(domainExpr, i);
-                elementAssign(eid, resultBuffer + k * elementSize, ptr);
-                k += 1;
-            }
-        }
-        int64_t dims[1] = {k};
-        vars[nFilter] = variableMalloc();
-        variableInitFromNDArray(vars[nFilter], false, eid, 1, dims, resultBuffer, false);
+    if (elementSize == sizeof(int32_t)) {
+        FILTER_SCATTER(int32_t, buckets, filled, domainData, accept, rowWords, nFilter, domainSize);
+    } else {
+        FILTER_SCATTER(int8_t, buckets, filled, domainData, accept, rowWords, nFilter, domainSize);
     }
 
-    arrayFree(eid, resultBuffer, domainSize);
+    free(filled);
+    free(buckets);
+    if (gathered != NULL)
+        arrayFree(eid, gathered, domainSize);
 
     variableInitFromTupleLiteral(this, nFilter + 1, vars);
     for (int64_t i = 0; i <= nFilter; i++)
@@ -81,11 +81,20 @@ void variableInitFromEmptyArray(Variable *this);
  * @param vars element in the vector; for matrix this would be vector literals
  */
 void variableInitFromGeneratorArray(Variable *this, int64_t nVars, Variable **vars);
+/**
+ * Create the result of a generator whose element type is known at compile time; the caller writes each element
+ * directly into m_data (row major for matrix), which starts out as null values
+ * creates empty array if the generator has no rows
+ * @param this the variable to initialize as the result vector or matrix
+ * @param eid the element type of every generated value
+ */
+void variableInitFromTypedGeneratorVector(Variable *this, ElementTypeID eid, int64_t length);
+void variableInitFromTypedGeneratorMatrix(Variable *this, ElementTypeID eid, int64_t nRow, int64_t nCol);
 /**
  * Creates a tuple with nFilter + 1 fields from a filter construct
  * @param this The variable to initialize as tuple
  * @param nFilter the number of filter expressions in the filter
  * @param domainExpr the single domain expression that this filter loops on
- * @param accept a (flattened) matrix, an element accept[i][j] gives whether the result of evaluating the jth expression on ith domain variable is true
+ * @param accept a bit matrix from acceptMatrixMalloc(), bit j of row i gives whether the ith expression is true on the jth domain variable
  */
-void variableInitFromFilterArray(Variable *this, int64_t nFilter, Variable *domainExpr, bool *accept);
\ No newline at end of file
+void variableInitFromFilterArray(Variable *this, int64_t nFilter, Variable *domainExpr, uint64_t *accept);
\ No newline at end of file
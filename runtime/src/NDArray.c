@@ -3,6 +3,9 @@
 #include "math.h"
 #include "string.h"
 #include "VariableStdio.h"
+#include "FreeList.h"
+#include "NDArraySIMD.h"
+#include "ThreadPool.h"
 
 void mixedTypeElementInitFromValue(MixedTypeElement *this, ElementTypeID eid, void *value) {
     switch (eid) {
@@ -12,7 +15,7 @@ void mixedTypeElementInitFromValue(MixedTypeElement *this, ElementTypeID eid, vo
         case ELEMENT_CHARACTER: {
             this->m_elementTypeID = eid;
             int64_t elementSize = elementGetSize(eid);
-            this->m_element = malloc(elementSize);
+            this->m_element = freeListPoolMalloc(elementSize);
             elementAssign(eid, this->m_element, value);
         } break;
         case ELEMENT_NULL:
@@ -24,7 +27,7 @@ void mixedTypeElementInitFromValue(MixedTypeElement *this, ElementTypeID eid, vo
             this->m_elementTypeID = other->m_elementTypeID;
             int64_t elementSize = elementGetSize(other->m_elementTypeID);
             void *otherValue = other->m_element;
-            this->m_element = malloc(elementSize);
+            this->m_element = freeListPoolMalloc(elementSize);
             elementAssign(other->m_elementTypeID, this->m_element, otherValue);
         }
         default:
@@ -221,7 +224,7 @@ void elementMallocFromCast(ElementTypeID resultID, ElementTypeID srcID, void *sr
         return;
     }
     if (resultID == ELEMENT_BOOLEAN) {
-        bool *resultBool = malloc(sizeof(bool));
+        bool *resultBool = freeListPoolMalloc(sizeof(bool));
         *result = resultBool;
         switch (srcID) {
             case ELEMENT_CHARACTER:
@@ -233,7 +236,7 @@ void elementMallocFromCast(ElementTypeID resultID, ElementTypeID srcID, void *sr
             default: errorAndExit("This should not happen!"); break;
         }
     } else if (resultID == ELEMENT_CHARACTER) {
-        int8_t *resultChar = malloc(sizeof(int8_t));
+        int8_t *resultChar = freeListPoolMalloc(sizeof(int8_t));
         *result = resultChar;
         switch (srcID) {
             case ELEMENT_BOOLEAN:
@@ -245,7 +248,7 @@ void elementMallocFromCast(ElementTypeID resultID, ElementTypeID srcID, void *sr
             default: errorAndExit("This should not happen!"); break;
         }
     } else if (resultID == ELEMENT_INTEGER) {
-        int32_t *resultInt = malloc(sizeof(int32_t));
+        int32_t *resultInt = freeListPoolMalloc(sizeof(int32_t));
         *result = resultInt;
         switch (srcID) {
             case ELEMENT_BOOLEAN:
@@ -258,7 +261,7 @@ void elementMallocFromCast(ElementTypeID resultID, ElementTypeID srcID, void *sr
             default: errorAndExit("This should not happen!"); break;
         }
     } else if (resultID == ELEMENT_REAL) {
-        float *resultFloat = malloc(sizeof(float));
+        float *resultFloat = freeListPoolMalloc(sizeof(float));
         *result = resultFloat;
         switch (srcID) {
             case ELEMENT_BOOLEAN:
@@ -322,7 +325,7 @@ void elementMallocFromBinOp(ElementTypeID id, BinOpCode opcode, void *op1, void
     if (id == ELEMENT_BOOLEAN) {
         bool v1 = *((bool *)op1);
         bool v2 = *((bool *)op2);
-        bool *resultBool = malloc(sizeof(bool));
+        bool *resultBool = freeListPoolMalloc(sizeof(bool));
         *result = resultBool;
         switch(opcode) {
             case BINARY_EQ:
@@ -454,7 +457,7 @@ void *arrayMallocFromIdentity(ElementTypeID id, int64_t size) {
 void *arrayMallocFromElementValue(ElementTypeID id, int64_t size, void *value) {
     if (elementIsBasicType(id) || id == ELEMENT_MIXED) {
         int64_t elementSize = elementGetSize(id);
-        char *target = malloc(elementSize * size);
+        char *target = freeListPoolMalloc(elementSize * size);
 
         if (id == ELEMENT_MIXED) {
             MixedTypeElement *element = value;
@@ -476,12 +479,12 @@ void *arrayMallocFromElementValue(ElementTypeID id, int64_t size, void *value) {
 void *arrayMallocFromMemcpy(ElementTypeID id, int64_t size, void *value) {
     if (elementIsBasicType(id)) {
         int64_t elementSize = elementGetSize(id);
-        void *target = malloc(elementSize * size);
+        void *target = freeListPoolMalloc(elementSize * size);
         memcpy(target, value, elementSize * size);
         return target;
     } else if (elementIsMixedType(id)) {
         int64_t elementSize = elementGetSize(id);
-        char *target = malloc(elementSize * size);
+        char *target = freeListPoolMalloc(elementSize * size);
         char *src = value;
         for (int64_t i = 0; i < size; i++) {
             MixedTypeElement *element = (void *)(src + i * elementSize);
@@ -494,25 +497,25 @@ void *arrayMallocFromMemcpy(ElementTypeID id, int64_t size, void *value) {
 
 // typed versions of arrayMallocFromElementValue
 void *arrayMallocFromBoolValue(int64_t size, bool value) {
-    bool *arr = malloc(sizeof(bool) * size);
+    bool *arr = freeListPoolMalloc(sizeof(bool) * size);
     for (int64_t i = 0; i < size; i++)
         arr[i] = value;
     return arr;
 }
 void *arrayMallocFromCharacterValue(int64_t size, int8_t value) {
-    int8_t *arr = malloc(sizeof(int8_t) * size);
+    int8_t *arr = freeListPoolMalloc(sizeof(int8_t) * size);
     for (int64_t i = 0; i < size; i++)
         arr[i] = value;
     return arr;
 }
 void *arrayMallocFromIntegerValue(int64_t size, int32_t value) {
-    int32_t *arr = malloc(sizeof(int32_t) * size);
+    int32_t *arr = freeListPoolMalloc(sizeof(int32_t) * size);
     for (int64_t i = 0; i < size; i++)
         arr[i] = value;
     return arr;
 }
 void *arrayMallocFromRealValue(int64_t size, float value) {
-    float *arr = malloc(sizeof(float) * size);
+    float *arr = freeListPoolMalloc(sizeof(float) * size);
     for (int64_t i = 0; i < size; i++)
         arr[i] = value;
     return arr;
@@ -520,15 +523,15 @@ void *arrayMallocFromRealValue(int64_t size, float value) {
 
 void arrayFree(ElementTypeID id, void *arr, int64_t size) {
     if (elementIsBasicType(id)) {
-        free(arr);
+        freeListPoolFree(arr);
     } else if (elementIsMixedType(id)) {
         MixedTypeElement *ptr = arr;
         for (int64_t i = 0; i < size; i++) {
             if (elementIsBasicType(ptr[i].m_elementTypeID))
-                free(ptr[i].m_element);
+                freeListPoolFree(ptr[i].m_element);
         }
         // then free the pointer array itself
-        free(arr);
+        freeListPoolFree(arr);
     }
 }
 
@@ -584,7 +587,7 @@ void arrayMallocFromUnaryOp(ElementTypeID id, UnaryOpCode opcode, void *src, int
         void *temp;
         arrayMallocFromPromote(eid, id, length, src, &temp);
         arrayMallocFromUnaryOp(eid, opcode, temp, length, result);
-        free(temp);
+        freeListPoolFree(temp);
     } else {
         errorAndExit("This should not happen!");
     }
@@ -656,6 +659,140 @@ bool arrayBinopResultType(ElementTypeID id, BinOpCode opcode, ElementTypeID *res
     return false;
 }
 
+/// element-wise binop kernels
+// each kernel writes op1[i] <op> op2[i] straight into the result buffer, in a plain loop the C compiler can vectorize
+// these are the fallbacks for the ops and cpus NDArraySIMD.c has no kernel for
+
+#define ARRAY_BINOP_KERNEL(name, opType, resultType, expr)                      \
+    void name(void *op1, void *op2, void *result, int64_t size) {               \
+        const opType *restrict a = op1;                                         \
+        const opType *restrict b = op2;                                         \
+        resultType *restrict r = result;                                        \
+        for (int64_t i = 0; i < size; i++)                                      \
+            r[i] = (expr);                                                      \
+    }
+
+ARRAY_BINOP_KERNEL(arrayIntegerPlusKernel, int32_t, int32_t, a[i] + b[i])
+ARRAY_BINOP_KERNEL(arrayIntegerMinusKernel, int32_t, int32_t, a[i] - b[i])
+ARRAY_BINOP_KERNEL(arrayIntegerMultiplyKernel, int32_t, int32_t, a[i] * b[i])
+ARRAY_BINOP_KERNEL(arrayIntegerExponentKernel, int32_t, int32_t, integerExponentiation(a[i], b[i]))
+ARRAY_BINOP_KERNEL(arrayIntegerLTKernel, int32_t, bool, a[i] < b[i])
+ARRAY_BINOP_KERNEL(arrayIntegerBTKernel, int32_t, bool, a[i] > b[i])
+ARRAY_BINOP_KERNEL(arrayIntegerLEQKernel, int32_t, bool, a[i] <= b[i])
+ARRAY_BINOP_KERNEL(arrayIntegerBEQKernel, int32_t, bool, a[i] >= b[i])
+
+ARRAY_BINOP_KERNEL(arrayRealPlusKernel, float, float, a[i] + b[i])
+ARRAY_BINOP_KERNEL(arrayRealMinusKernel, float, float, a[i] - b[i])
+ARRAY_BINOP_KERNEL(arrayRealMultiplyKernel, float, float, a[i] * b[i])
+ARRAY_BINOP_KERNEL(arrayRealDivideKernel, float, float, a[i] / b[i])
+ARRAY_BINOP_KERNEL(arrayRealRemainderKernel, float, float, fmodf(a[i], b[i]))
+ARRAY_BINOP_KERNEL(arrayRealExponentKernel, float, float, powf(a[i], b[i]))
+ARRAY_BINOP_KERNEL(arrayRealLTKernel, float, bool, a[i] < b[i])
+ARRAY_BINOP_KERNEL(arrayRealBTKernel, float, bool, a[i] > b[i])
+ARRAY_BINOP_KERNEL(arrayRealLEQKernel, float, bool, a[i] <= b[i])
+ARRAY_BINOP_KERNEL(arrayRealBEQKernel, float, bool, a[i] >= b[i])
+
+ARRAY_BINOP_KERNEL(arrayBoolAndKernel, bool, bool, a[i] && b[i])
+ARRAY_BINOP_KERNEL(arrayBoolOrKernel, bool, bool, a[i] || b[i])
+ARRAY_BINOP_KERNEL(arrayBoolXorKernel, bool, bool, a[i] ^ b[i])
+
+// the zero check is a separate pass so the division loops themselves stay branch free
+bool arrayIntegerHasZero(const int32_t *arr, int64_t size) {
+    bool hasZero = false;
+    for (int64_t i = 0; i < size; i++)
+        hasZero |= arr[i] == 0;
+    return hasZero;
+}
+void arrayIntegerDivideKernel(void *op1, void *op2, void *result, int64_t size) {
+    if (arrayIntegerHasZero(op2, size)) {
+        errorAndExit("Attempt to divide by zero!");
+    }
+    const int32_t *restrict a = op1;
+    const int32_t *restrict b = op2;
+    int32_t *restrict r = result;
+    for (int64_t i = 0; i < size; i++)
+        r[i] = a[i] / b[i];
+}
+void arrayIntegerRemainderKernel(void *op1, void *op2, void *result, int64_t size) {
+    if (arrayIntegerHasZero(op2, size)) {
+        errorAndExit("Attempt to mod by zero!");
+    }
+    const int32_t *restrict a = op1;
+    const int32_t *restrict b = op2;
+    int32_t *restrict r = result;
+    for (int64_t i = 0; i < size; i++)
+        r[i] = (int) ((long) a[i] % (long) b[i]);
+}
+
+ArrayBinOpKernel arrayIntegerBinOpKernels[NUM_BINARY_OPS] = {
+    [BINARY_EXPONENT] = arrayIntegerExponentKernel,
+    [BINARY_MULTIPLY] = arrayIntegerMultiplyKernel,
+    [BINARY_DIVIDE] = arrayIntegerDivideKernel,
+    [BINARY_REMAINDER] = arrayIntegerRemainderKernel,
+    [BINARY_PLUS] = arrayIntegerPlusKernel,
+    [BINARY_MINUS] = arrayIntegerMinusKernel,
+    [BINARY_LT] = arrayIntegerLTKernel,
+    [BINARY_BT] = arrayIntegerBTKernel,
+    [BINARY_LEQ] = arrayIntegerLEQKernel,
+    [BINARY_BEQ] = arrayIntegerBEQKernel,
+};
+ArrayBinOpKernel arrayRealBinOpKernels[NUM_BINARY_OPS] = {
+    [BINARY_EXPONENT] = arrayRealExponentKernel,
+    [BINARY_MULTIPLY] = arrayRealMultiplyKernel,
+    [BINARY_DIVIDE] = arrayRealDivideKernel,
+    [BINARY_REMAINDER] = arrayRealRemainderKernel,
+    [BINARY_PLUS] = arrayRealPlusKernel,
+    [BINARY_MINUS] = arrayRealMinusKernel,
+    [BINARY_LT] = arrayRealLTKernel,
+    [BINARY_BT] = arrayRealBTKernel,
+    [BINARY_LEQ] = arrayRealLEQKernel,
+    [BINARY_BEQ] = arrayRealBEQKernel,
+};
+ArrayBinOpKernel arrayBoolBinOpKernels[NUM_BINARY_OPS] = {
+    [BINARY_AND] = arrayBoolAndKernel,
+    [BINARY_OR] = arrayBoolOrKernel,
+    [BINARY_XOR] = arrayBoolXorKernel,
+};
+
+// returns NULL if there is no kernel for the element type and opcode
+ArrayBinOpKernel arrayGetBinOpKernel(ElementTypeID id, BinOpCode opcode) {
+    ArrayBinOpKernel simdKernel = arraySIMDGetBinOpKernel(id, opcode);
+    if (simdKernel != NULL)
+        return simdKernel;
+    switch (id) {
+        case ELEMENT_INTEGER:
+            return arrayIntegerBinOpKernels[opcode];
+        case ELEMENT_REAL:
+            return arrayRealBinOpKernels[opcode];
+        case ELEMENT_BOOLEAN:
+            return arrayBoolBinOpKernels[opcode];
+        default:
+            return NULL;
+    }
+}
+
+#define BINOP_PARALLEL_GRAIN (1 << 16)  // elements per parallel task, shorter arrays run on the calling thread
+
+typedef struct struct_gazprea_binop_args {
+    ArrayBinOpKernel m_kernel;
+    char *m_op1;
+    char *m_op2;
+    char *m_result;
+    int64_t m_elementSize;
+    int64_t m_resultElementSize;
+} BinOpArgs;
+
+void arrayBinOpChunk(void *arg, int64_t begin, int64_t end) {
+    BinOpArgs *args = arg;
+    args->m_kernel(args->m_op1 + begin * args->m_elementSize, args->m_op2 + begin * args->m_elementSize,
+                   args->m_result + begin * args->m_resultElementSize, end - begin);
+}
+
+// integer division and remainder exit on a zero divisor, which must happen on the calling thread
+bool arrayBinOpCanRunInParallel(ElementTypeID id, BinOpCode opcode) {
+    return !(id == ELEMENT_INTEGER && (opcode == BINARY_DIVIDE || opcode == BINARY_REMAINDER));
+}
+
 void arrayMallocFromBinOp(ElementTypeID id, BinOpCode opcode, void *op1, int64_t op1Size, void *op2, int64_t op2Size, void **result, int64_t *resultSize) {
     ElementTypeID resultEID;
     bool resultCollapseToScalar;
@@ -676,22 +813,19 @@ void arrayMallocFromBinOp(ElementTypeID id, BinOpCode opcode, void *op1, int64_t
     // op1Size should be the same as op2Size except for concatenation '||'
     if (opcode == BINARY_CONCAT) {
         resultArraySize = op1Size + op2Size;
-        resultPos = malloc(resultArraySize * resultElementSize);
+        resultPos = freeListPoolMalloc(resultArraySize * resultElementSize);
         memcpy(resultPos, op1, op1Size * elementSize);
         memcpy(resultPos + op1Size * elementSize, op2, op2Size * elementSize);
     } else if (opcode == BINARY_DOT_PRODUCT) {
         resultArraySize = 1;
 
         void *sum = arrayMallocFromNull(resultEID, 1);
-        for (int64_t i = 0; i < op1Size; i++) {
-            // sum += op1[i] * op2[i]
-            void *temp;
-            void *tempSum;
-            elementMallocFromBinOp(id, BINARY_MULTIPLY, op1Pos + i * elementSize, op2Pos + i * elementSize, &temp);
-            elementMallocFromBinOp(resultEID, BINARY_PLUS, sum, temp, &tempSum);
-            free(temp);
-            free(sum);
-            sum = tempSum;
+        if (id == ELEMENT_INTEGER) {
+            *(int32_t *)sum = arraySIMDIntegerDotProduct(op1, op2, op1Size);
+        } else if (id == ELEMENT_REAL) {
+            *(float *)sum = arraySIMDRealDotProduct(op1, op2, op1Size);
+        } else {
+            errorAndExit("This should not happen!");
         }
         resultPos = sum;
     } else if (opcode == BINARY_EQ || opcode == BINARY_NE) {
@@ -704,12 +838,16 @@ void arrayMallocFromBinOp(ElementTypeID id, BinOpCode opcode, void *op1, int64_t
         resultPos = (void *)aggregate;
     } else {  // for other operators, this is same as scalar case i.e. the binop is done element-wise
         resultArraySize = op1Size;
-        resultPos = malloc(resultArraySize * resultElementSize);
-        for (int64_t i = 0; i < resultArraySize; i++) {
-            void *temp;
-            elementMallocFromBinOp(id, opcode, op1Pos + i * elementSize, op2Pos + i * elementSize, &temp);
-            memcpy(resultPos + i * resultElementSize, temp, resultElementSize);
-            free(temp);
+        resultPos = freeListPoolMalloc(resultArraySize * resultElementSize);
+        ArrayBinOpKernel kernel = arrayGetBinOpKernel(id, opcode);
+        if (kernel == NULL) {
+            errorAndExit("This should not happen!");
+        }
+        if (resultArraySize > BINOP_PARALLEL_GRAIN && arrayBinOpCanRunInParallel(id, opcode)) {
+            BinOpArgs args = {kernel, op1, op2, resultPos, elementSize, resultElementSize};
+            threadPoolParallelFor(0, resultArraySize, BINOP_PARALLEL_GRAIN, arrayBinOpChunk, &args);
+        } else {
+            kernel(op1, op2, resultPos, resultArraySize);
         }
     }
     *result = resultPos;
@@ -720,7 +858,7 @@ void arrayMallocFromBinOp(ElementTypeID id, BinOpCode opcode, void *op1, int64_t
 void arrayMallocFromCastPromote(ElementTypeID resultID, ElementTypeID srcID, int64_t size, void *src, void **result,
     void conversion(ElementTypeID, ElementTypeID, void*, void**)) {
     int64_t resultElementSize = elementGetSize(resultID);
-    char *resultPos = malloc(resultElementSize * size);
+    char *resultPos = freeListPoolMalloc(resultElementSize * size);
 
     if (srcID == ELEMENT_MIXED) {
         MixedTypeElement *mixed = src;
@@ -729,7 +867,7 @@ void arrayMallocFromCastPromote(ElementTypeID resultID, ElementTypeID srcID, int
             void *temp;
             conversion(resultID, eid, mixed[i].m_element, &temp);
             memcpy(resultPos + resultElementSize * i, temp, resultElementSize);
-            free(temp);
+            freeListPoolFree(temp);
         }
     } else {
         int64_t srcElementSize = elementGetSize(srcID);
@@ -738,7 +876,7 @@ void arrayMallocFromCastPromote(ElementTypeID resultID, ElementTypeID srcID, int
             void *temp;
             conversion(resultID, srcID, srcPos + i * srcElementSize, &temp);
             memcpy(resultPos + resultElementSize * i, temp, resultElementSize);
-            free(temp);
+            freeListPoolFree(temp);
         }
     }
     *result = resultPos;
@@ -770,40 +908,66 @@ bool arrayMixedElementCanBePromotedToSameType(MixedTypeElement *arr, int64_t siz
     return numNull == 0 || numIdentity == 0 || numNull + numIdentity < size;  // all identity, all null or exist some other type
 }
 
-// n * m matrix multiply by m * k matrix to produce a n * k matrix
-void arrayMallocFromMatrixMultiplication(ElementTypeID id, void *op1, void *op2, int64_t n, int64_t m, int64_t k, void **result) {
-    if (id == ELEMENT_INTEGER) {
-        int32_t *mat1 = op1;
-        int32_t *mat2 = op2;
-        int32_t *mat3 = arrayMallocFromNull(id, n * k);
-        for (int64_t i = 0; i < n; i++) {
-            for (int64_t j = 0; j < k; j++) {
-                int32_t sum = 0;
-                for (int64_t l = 0; l < m; l++) {
-                    sum += mat1[i * m + l] * mat2[l * k + j];
+/// matrix multiplication
+// the result is computed in row blocks (split across the thread pool) of column/inner blocks, each row of a block
+// accumulates mat1[i][l] * (row l of mat2) with a SIMD axpy; for every result element the products are still added
+// in increasing l order, so the result is the same as the naive triple loop
+#define GEMM_BLOCK_ROWS 32        // rows of the result per parallel task
+#define GEMM_BLOCK_INNER 256      // rows of mat2 kept in cache while a row block runs over them
+#define GEMM_BLOCK_COLS 1024      // columns of the result per block, so the mat2 block is at most 1 MiB
+#define GEMM_PARALLEL_THRESHOLD (64 * 64 * 64)  // n * m * k below which a single thread is faster
+
+typedef struct struct_gazprea_gemm_args {
+    ElementTypeID m_id;
+    void *m_mat1;
+    void *m_mat2;
+    void *m_result;
+    int64_t m_m;
+    int64_t m_k;
+} GemmArgs;
+
+void arrayGemmRowBlocks(void *arg, int64_t rowBegin, int64_t rowEnd) {
+    GemmArgs *args = arg;
+    int64_t m = args->m_m;
+    int64_t k = args->m_k;
+    ArrayIntegerAxpyKernel integerAxpy = arraySIMDGetIntegerAxpy();
+    ArrayRealAxpyKernel realAxpy = arraySIMDGetRealAxpy();
+    for (int64_t jj = 0; jj < k; jj += GEMM_BLOCK_COLS) {
+        int64_t cols = k - jj < GEMM_BLOCK_COLS ? k - jj : GEMM_BLOCK_COLS;
+        for (int64_t ll = 0; ll < m; ll += GEMM_BLOCK_INNER) {
+            int64_t inner = m - ll < GEMM_BLOCK_INNER ? m - ll : GEMM_BLOCK_INNER;
+            for (int64_t i = rowBegin; i < rowEnd; i++) {
+                if (args->m_id == ELEMENT_INTEGER) {
+                    int32_t *mat1 = args->m_mat1;
+                    int32_t *mat2 = args->m_mat2;
+                    int32_t *resultRow = (int32_t *)args->m_result + i * k + jj;
+                    for (int64_t l = ll; l < ll + inner; l++)
+                        integerAxpy(resultRow, mat2 + l * k + jj, mat1[i * m + l], cols);
+                } else {
+                    float *mat1 = args->m_mat1;
+                    float *mat2 = args->m_mat2;
+                    float *resultRow = (float *)args->m_result + i * k + jj;
+                    for (int64_t l = ll; l < ll + inner; l++)
+                        realAxpy(resultRow, mat2 + l * k + jj, mat1[i * m + l], cols);
                 }
-                mat3[i * k + j] = sum;
             }
         }
-        *result = mat3;
-        return;
-    } else if (id == ELEMENT_REAL) {
-        float *mat1 = op1;
-        float *mat2 = op2;
-        float *mat3 = arrayMallocFromNull(id, n * k);
-        for (int64_t i = 0; i < n; i++) {
-            for (int64_t j = 0; j < k; j++) {
-                float sum = 0;
-                for (int64_t l = 0; l < m; l++) {
-                    sum += mat1[i * m + l] * mat2[l * k + j];
-                }
-                mat3[i * k + j] = sum;
-            }
-        }
-        *result = mat3;
-        return;
     }
-    errorAndExit("Invalid matrix multiplication base type!");
+}
+
+// n * m matrix multiply by m * k matrix to produce a n * k matrix
+void arrayMallocFromMatrixMultiplication(ElementTypeID id, void *op1, void *op2, int64_t n, int64_t m, int64_t k, void **result) {
+    if (id != ELEMENT_INTEGER && id != ELEMENT_REAL) {
+        errorAndExit("Invalid matrix multiplication base type!");
+    }
+    void *mat3 = arrayMallocFromNull(id, n * k);
+    GemmArgs args = {id, op1, op2, mat3, m, k};
+    if (n * m * k >= GEMM_PARALLEL_THRESHOLD) {
+        threadPoolParallelFor(0, n, GEMM_BLOCK_ROWS, arrayGemmRowBlocks, &args);
+    } else {
+        arrayGemmRowBlocks(&args, 0, n);
+    }
+    *result = mat3;
 }
 
 void arrayMallocFromVectorResize(ElementTypeID id, void *old, int64_t oldSize, int64_t newSize, void **result) {
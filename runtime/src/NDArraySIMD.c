@@ -0,0 +1,503 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "NDArraySIMD.h"
+
+// mul then add must not be fused into fma where the result has to match the scalar code, CMakeLists.txt builds
+// this file with -ffp-contract=off
+
+void scalarIntegerAxpy(int32_t *y, const int32_t *x, int32_t a, int64_t size) {
+    for (int64_t i = 0; i < size; i++)
+        y[i] = (int32_t)((uint32_t)y[i] + (uint32_t)a * (uint32_t)x[i]);
+}
+
+void scalarRealAxpy(float *y, const float *x, float a, int64_t size) {
+    for (int64_t i = 0; i < size; i++)
+        y[i] += a * x[i];
+}
+
+float scalarRealDotProduct(const float *a, const float *b, int64_t size) {
+    float total = 0.0f;
+    for (int64_t i = 0; i < size; i++)
+        total += a[i] * b[i];
+    return total;
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+
+/// real dot product reduction order
+// every level accumulates into the same REAL_DOT_LANES partial sums, lane j sums a[i] * b[i] for the i = j mod
+// REAL_DOT_LANES of the whole blocks in increasing i, SSE2 holds the lanes in four registers, AVX2 in two and AVX-512
+// in one; the lanes are then folded pairwise (lane j += lane j + half, halving until one is left) and the tail
+// elements are added in order, so the sum is the same at every level and only differs from the in order loop
+#define REAL_DOT_LANES 16
+
+float realDotFoldLanes(float *lanes, const float *a, const float *b, int64_t i, int64_t size) {
+    for (int half = REAL_DOT_LANES / 2; half > 0; half /= 2)
+        for (int lane = 0; lane < half; lane++)
+            lanes[lane] += lanes[lane + half];
+    float total = lanes[0];
+    for (; i < size; i++)
+        total += a[i] * b[i];
+    return total;
+}
+
+/// kernel skeleton
+// the vector loop handles whole registers of WIDTH elements and the scalar loop handles the tail
+#define SIMD_BINOP_KERNEL(name, isa, vecType, WIDTH, opType, resultType, load, store, vecExpr, scalarExpr)   \
+    __attribute__((target(isa)))                                                                            \
+    void name(void *op1, void *op2, void *result, int64_t size) {                                          \
+        const opType *a = op1;                                                                              \
+        const opType *b = op2;                                                                              \
+        resultType *r = result;                                                                             \
+        int64_t i = 0;                                                                                      \
+        for (; i + WIDTH <= size; i += WIDTH) {                                                             \
+            vecType va = load(a + i);                                                                       \
+            vecType vb = load(b + i);                                                                       \
+            store(r + i, (vecExpr));                                                                        \
+        }                                                                                                   \
+        for (; i < size; i++)                                                                               \
+            r[i] = (scalarExpr);                                                                            \
+    }
+
+///------------------------------SSE2---------------------------------------------------------------
+
+#define SSE2_LOADI(p) _mm_loadu_si128((const __m128i *)(p))
+#define SSE2_STOREI(p, v) _mm_storeu_si128((__m128i *)(p), v)
+#define SSE2_LOADF(p) _mm_loadu_ps(p)
+#define SSE2_STOREF(p, v) _mm_storeu_ps(p, v)
+// all ones lanes to 1, all zeros lanes to 0
+#define SSE2_MASK_TO_BOOL(m) _mm_srli_epi32(m, 31)
+#define SSE2_NOT_BOOL(v) _mm_xor_si128(v, _mm_set1_epi32(1))
+
+// SSE2 has no 32 bit low multiply, multiply the even and odd lanes separately and interleave the low halves
+__attribute__((target("sse2")))
+__m128i sse2MulloEpi32(__m128i a, __m128i b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+SIMD_BINOP_KERNEL(sse2IntegerPlus, "sse2", __m128i, 4, int32_t, int32_t, SSE2_LOADI, SSE2_STOREI,
+                  _mm_add_epi32(va, vb), a[i] + b[i])
+SIMD_BINOP_KERNEL(sse2IntegerMinus, "sse2", __m128i, 4, int32_t, int32_t, SSE2_LOADI, SSE2_STOREI,
+                  _mm_sub_epi32(va, vb), a[i] - b[i])
+SIMD_BINOP_KERNEL(sse2IntegerMultiply, "sse2", __m128i, 4, int32_t, int32_t, SSE2_LOADI, SSE2_STOREI,
+                  sse2MulloEpi32(va, vb), a[i] * b[i])
+SIMD_BINOP_KERNEL(sse2IntegerLT, "sse2", __m128i, 4, int32_t, bool, SSE2_LOADI, SSE2_STOREI,
+                  SSE2_MASK_TO_BOOL(_mm_cmplt_epi32(va, vb)), a[i] < b[i])
+SIMD_BINOP_KERNEL(sse2IntegerBT, "sse2", __m128i, 4, int32_t, bool, SSE2_LOADI, SSE2_STOREI,
+                  SSE2_MASK_TO_BOOL(_mm_cmpgt_epi32(va, vb)), a[i] > b[i])
+SIMD_BINOP_KERNEL(sse2IntegerLEQ, "sse2", __m128i, 4, int32_t, bool, SSE2_LOADI, SSE2_STOREI,
+                  SSE2_NOT_BOOL(SSE2_MASK_TO_BOOL(_mm_cmpgt_epi32(va, vb))), a[i] <= b[i])
+SIMD_BINOP_KERNEL(sse2IntegerBEQ, "sse2", __m128i, 4, int32_t, bool, SSE2_LOADI, SSE2_STOREI,
+                  SSE2_NOT_BOOL(SSE2_MASK_TO_BOOL(_mm_cmplt_epi32(va, vb))), a[i] >= b[i])
+
+SIMD_BINOP_KERNEL(sse2RealPlus, "sse2", __m128, 4, float, float, SSE2_LOADF, SSE2_STOREF,
+                  _mm_add_ps(va, vb), a[i] + b[i])
+SIMD_BINOP_KERNEL(sse2RealMinus, "sse2", __m128, 4, float, float, SSE2_LOADF, SSE2_STOREF,
+                  _mm_sub_ps(va, vb), a[i] - b[i])
+SIMD_BINOP_KERNEL(sse2RealMultiply, "sse2", __m128, 4, float, float, SSE2_LOADF, SSE2_STOREF,
+                  _mm_mul_ps(va, vb), a[i] * b[i])
+SIMD_BINOP_KERNEL(sse2RealDivide, "sse2", __m128, 4, float, float, SSE2_LOADF, SSE2_STOREF,
+                  _mm_div_ps(va, vb), a[i] / b[i])
+SIMD_BINOP_KERNEL(sse2RealLT, "sse2", __m128, 4, float, bool, SSE2_LOADF, SSE2_STOREI,
+                  SSE2_MASK_TO_BOOL(_mm_castps_si128(_mm_cmplt_ps(va, vb))), a[i] < b[i])
+SIMD_BINOP_KERNEL(sse2RealBT, "sse2", __m128, 4, float, bool, SSE2_LOADF, SSE2_STOREI,
+                  SSE2_MASK_TO_BOOL(_mm_castps_si128(_mm_cmpgt_ps(va, vb))), a[i] > b[i])
+SIMD_BINOP_KERNEL(sse2RealLEQ, "sse2", __m128, 4, float, bool, SSE2_LOADF, SSE2_STOREI,
+                  SSE2_MASK_TO_BOOL(_mm_castps_si128(_mm_cmple_ps(va, vb))), a[i] <= b[i])
+SIMD_BINOP_KERNEL(sse2RealBEQ, "sse2", __m128, 4, float, bool, SSE2_LOADF, SSE2_STOREI,
+                  SSE2_MASK_TO_BOOL(_mm_castps_si128(_mm_cmpge_ps(va, vb))), a[i] >= b[i])
+
+__attribute__((target("sse2")))
+int32_t sse2IntegerDotProduct(const int32_t *a, const int32_t *b, int64_t size) {
+    __m128i sum = _mm_setzero_si128();
+    int64_t i = 0;
+    for (; i + 4 <= size; i += 4)
+        sum = _mm_add_epi32(sum, sse2MulloEpi32(SSE2_LOADI(a + i), SSE2_LOADI(b + i)));
+    int32_t lanes[4];
+    SSE2_STOREI(lanes, sum);
+    // unsigned so the wrap around matches the scalar loop without signed overflow
+    uint32_t total = (uint32_t)lanes[0] + (uint32_t)lanes[1] + (uint32_t)lanes[2] + (uint32_t)lanes[3];
+    for (; i < size; i++)
+        total += (uint32_t)a[i] * (uint32_t)b[i];
+    return (int32_t)total;
+}
+
+__attribute__((target("sse2")))
+float sse2RealDotProduct(const float *a, const float *b, int64_t size) {
+    __m128 sum[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+    int64_t i = 0;
+    for (; i + REAL_DOT_LANES <= size; i += REAL_DOT_LANES)
+        for (int reg = 0; reg < 4; reg++)
+            sum[reg] = _mm_add_ps(sum[reg], _mm_mul_ps(SSE2_LOADF(a + i + 4 * reg), SSE2_LOADF(b + i + 4 * reg)));
+    float lanes[REAL_DOT_LANES];
+    for (int reg = 0; reg < 4; reg++)
+        SSE2_STOREF(lanes + 4 * reg, sum[reg]);
+    return realDotFoldLanes(lanes, a, b, i, size);
+}
+
+// the multiply and add are kept separate (no fma) so the matrix product rounds exactly like the scalar loop
+__attribute__((target("sse2")))
+void sse2IntegerAxpy(int32_t *y, const int32_t *x, int32_t a, int64_t size) {
+    __m128i va = _mm_set1_epi32(a);
+    int64_t i = 0;
+    for (; i + 4 <= size; i += 4)
+        SSE2_STOREI(y + i, _mm_add_epi32(SSE2_LOADI(y + i), sse2MulloEpi32(va, SSE2_LOADI(x + i))));
+    scalarIntegerAxpy(y + i, x + i, a, size - i);
+}
+
+__attribute__((target("sse2")))
+void sse2RealAxpy(float *y, const float *x, float a, int64_t size) {
+    __m128 va = _mm_set1_ps(a);
+    int64_t i = 0;
+    for (; i + 4 <= size; i += 4)
+        SSE2_STOREF(y + i, _mm_add_ps(SSE2_LOADF(y + i), _mm_mul_ps(va, SSE2_LOADF(x + i))));
+    scalarRealAxpy(y + i, x + i, a, size - i);
+}
+
+///------------------------------AVX2---------------------------------------------------------------
+
+#define AVX2_LOADI(p) _mm256_loadu_si256((const __m256i *)(p))
+#define AVX2_STOREI(p, v) _mm256_storeu_si256((__m256i *)(p), v)
+#define AVX2_LOADF(p) _mm256_loadu_ps(p)
+#define AVX2_STOREF(p, v) _mm256_storeu_ps(p, v)
+#define AVX2_MASK_TO_BOOL(m) _mm256_srli_epi32(m, 31)
+#define AVX2_NOT_BOOL(v) _mm256_xor_si256(v, _mm256_set1_epi32(1))
+#define AVX2_CMP_PS_TO_BOOL(va, vb, pred) AVX2_MASK_TO_BOOL(_mm256_castps_si256(_mm256_cmp_ps(va, vb, pred)))
+
+SIMD_BINOP_KERNEL(avx2IntegerPlus, "avx2", __m256i, 8, int32_t, int32_t, AVX2_LOADI, AVX2_STOREI,
+                  _mm256_add_epi32(va, vb), a[i] + b[i])
+SIMD_BINOP_KERNEL(avx2IntegerMinus, "avx2", __m256i, 8, int32_t, int32_t, AVX2_LOADI, AVX2_STOREI,
+                  _mm256_sub_epi32(va, vb), a[i] - b[i])
+SIMD_BINOP_KERNEL(avx2IntegerMultiply, "avx2", __m256i, 8, int32_t, int32_t, AVX2_LOADI, AVX2_STOREI,
+                  _mm256_mullo_epi32(va, vb), a[i] * b[i])
+SIMD_BINOP_KERNEL(avx2IntegerLT, "avx2", __m256i, 8, int32_t, bool, AVX2_LOADI, AVX2_STOREI,
+                  AVX2_MASK_TO_BOOL(_mm256_cmpgt_epi32(vb, va)), a[i] < b[i])
+SIMD_BINOP_KERNEL(avx2IntegerBT, "avx2", __m256i, 8, int32_t, bool, AVX2_LOADI, AVX2_STOREI,
+                  AVX2_MASK_TO_BOOL(_mm256_cmpgt_epi32(va, vb)), a[i] > b[i])
+SIMD_BINOP_KERNEL(avx2IntegerLEQ, "avx2", __m256i, 8, int32_t, bool, AVX2_LOADI, AVX2_STOREI,
+                  AVX2_NOT_BOOL(AVX2_MASK_TO_BOOL(_mm256_cmpgt_epi32(va, vb))), a[i] <= b[i])
+SIMD_BINOP_KERNEL(avx2IntegerBEQ, "avx2", __m256i, 8, int32_t, bool, AVX2_LOADI, AVX2_STOREI,
+                  AVX2_NOT_BOOL(AVX2_MASK_TO_BOOL(_mm256_cmpgt_epi32(vb, va))), a[i] >= b[i])
+
+SIMD_BINOP_KERNEL(avx2RealPlus, "avx2", __m256, 8, float, float, AVX2_LOADF, AVX2_STOREF,
+                  _mm256_add_ps(va, vb), a[i] + b[i])
+SIMD_BINOP_KERNEL(avx2RealMinus, "avx2", __m256, 8, float, float, AVX2_LOADF, AVX2_STOREF,
+                  _mm256_sub_ps(va, vb), a[i] - b[i])
+SIMD_BINOP_KERNEL(avx2RealMultiply, "avx2", __m256, 8, float, float, AVX2_LOADF, AVX2_STOREF,
+                  _mm256_mul_ps(va, vb), a[i] * b[i])
+SIMD_BINOP_KERNEL(avx2RealDivide, "avx2", __m256, 8, float, float, AVX2_LOADF, AVX2_STOREF,
+                  _mm256_div_ps(va, vb), a[i] / b[i])
+SIMD_BINOP_KERNEL(avx2RealLT, "avx2", __m256, 8, float, bool, AVX2_LOADF, AVX2_STOREI,
+                  AVX2_CMP_PS_TO_BOOL(va, vb, _CMP_LT_OQ), a[i] < b[i])
+SIMD_BINOP_KERNEL(avx2RealBT, "avx2", __m256, 8, float, bool, AVX2_LOADF, AVX2_STOREI,
+                  AVX2_CMP_PS_TO_BOOL(va, vb, _CMP_GT_OQ), a[i] > b[i])
+SIMD_BINOP_KERNEL(avx2RealLEQ, "avx2", __m256, 8, float, bool, AVX2_LOADF, AVX2_STOREI,
+                  AVX2_CMP_PS_TO_BOOL(va, vb, _CMP_LE_OQ), a[i] <= b[i])
+SIMD_BINOP_KERNEL(avx2RealBEQ, "avx2", __m256, 8, float, bool, AVX2_LOADF, AVX2_STOREI,
+                  AVX2_CMP_PS_TO_BOOL(va, vb, _CMP_GE_OQ), a[i] >= b[i])
+
+__attribute__((target("avx2")))
+int32_t avx2IntegerDotProduct(const int32_t *a, const int32_t *b, int64_t size) {
+    __m256i sum = _mm256_setzero_si256();
+    int64_t i = 0;
+    for (; i + 8 <= size; i += 8)
+        sum = _mm256_add_epi32(sum, _mm256_mullo_epi32(AVX2_LOADI(a + i), AVX2_LOADI(b + i)));
+    int32_t lanes[8];
+    AVX2_STOREI(lanes, sum);
+    uint32_t total = 0;
+    for (int lane = 0; lane < 8; lane++)
+        total += (uint32_t)lanes[lane];
+    for (; i < size; i++)
+        total += (uint32_t)a[i] * (uint32_t)b[i];
+    return (int32_t)total;
+}
+
+__attribute__((target("avx2")))
+float avx2RealDotProduct(const float *a, const float *b, int64_t size) {
+    __m256 sumLow = _mm256_setzero_ps();
+    __m256 sumHigh = _mm256_setzero_ps();
+    int64_t i = 0;
+    for (; i + REAL_DOT_LANES <= size; i += REAL_DOT_LANES) {
+        sumLow = _mm256_add_ps(sumLow, _mm256_mul_ps(AVX2_LOADF(a + i), AVX2_LOADF(b + i)));
+        sumHigh = _mm256_add_ps(sumHigh, _mm256_mul_ps(AVX2_LOADF(a + i + 8), AVX2_LOADF(b + i + 8)));
+    }
+    float lanes[REAL_DOT_LANES];
+    AVX2_STOREF(lanes, sumLow);
+    AVX2_STOREF(lanes + 8, sumHigh);
+    return realDotFoldLanes(lanes, a, b, i, size);
+}
+
+__attribute__((target("avx2")))
+void avx2IntegerAxpy(int32_t *y, const int32_t *x, int32_t a, int64_t size) {
+    __m256i va = _mm256_set1_epi32(a);
+    int64_t i = 0;
+    for (; i + 8 <= size; i += 8)
+        AVX2_STOREI(y + i, _mm256_add_epi32(AVX2_LOADI(y + i), _mm256_mullo_epi32(va, AVX2_LOADI(x + i))));
+    scalarIntegerAxpy(y + i, x + i, a, size - i);
+}
+
+__attribute__((target("avx2")))
+void avx2RealAxpy(float *y, const float *x, float a, int64_t size) {
+    __m256 va = _mm256_set1_ps(a);
+    int64_t i = 0;
+    for (; i + 8 <= size; i += 8)
+        AVX2_STOREF(y + i, _mm256_add_ps(AVX2_LOADF(y + i), _mm256_mul_ps(va, AVX2_LOADF(x + i))));
+    scalarRealAxpy(y + i, x + i, a, size - i);
+}
+
+///------------------------------AVX-512---------------------------------------------------------------
+
+#define AVX512_LOADI(p) _mm512_loadu_si512((const void *)(p))
+#define AVX512_STOREI(p, v) _mm512_storeu_si512((void *)(p), v)
+#define AVX512_LOADF(p) _mm512_loadu_ps(p)
+#define AVX512_STOREF(p, v) _mm512_storeu_ps(p, v)
+#define AVX512_MASK_TO_BOOL(k) _mm512_maskz_set1_epi32(k, 1)
+
+SIMD_BINOP_KERNEL(avx512IntegerPlus, "avx512f", __m512i, 16, int32_t, int32_t, AVX512_LOADI, AVX512_STOREI,
+                  _mm512_add_epi32(va, vb), a[i] + b[i])
+SIMD_BINOP_KERNEL(avx512IntegerMinus, "avx512f", __m512i, 16, int32_t, int32_t, AVX512_LOADI, AVX512_STOREI,
+                  _mm512_sub_epi32(va, vb), a[i] - b[i])
+SIMD_BINOP_KERNEL(avx512IntegerMultiply, "avx512f", __m512i, 16, int32_t, int32_t, AVX512_LOADI, AVX512_STOREI,
+                  _mm512_mullo_epi32(va, vb), a[i] * b[i])
+SIMD_BINOP_KERNEL(avx512IntegerLT, "avx512f", __m512i, 16, int32_t, bool, AVX512_LOADI, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmplt_epi32_mask(va, vb)), a[i] < b[i])
+SIMD_BINOP_KERNEL(avx512IntegerBT, "avx512f", __m512i, 16, int32_t, bool, AVX512_LOADI, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmpgt_epi32_mask(va, vb)), a[i] > b[i])
+SIMD_BINOP_KERNEL(avx512IntegerLEQ, "avx512f", __m512i, 16, int32_t, bool, AVX512_LOADI, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmple_epi32_mask(va, vb)), a[i] <= b[i])
+SIMD_BINOP_KERNEL(avx512IntegerBEQ, "avx512f", __m512i, 16, int32_t, bool, AVX512_LOADI, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmpge_epi32_mask(va, vb)), a[i] >= b[i])
+
+SIMD_BINOP_KERNEL(avx512RealPlus, "avx512f", __m512, 16, float, float, AVX512_LOADF, AVX512_STOREF,
+                  _mm512_add_ps(va, vb), a[i] + b[i])
+SIMD_BINOP_KERNEL(avx512RealMinus, "avx512f", __m512, 16, float, float, AVX512_LOADF, AVX512_STOREF,
+                  _mm512_sub_ps(va, vb), a[i] - b[i])
+SIMD_BINOP_KERNEL(avx512RealMultiply, "avx512f", __m512, 16, float, float, AVX512_LOADF, AVX512_STOREF,
+                  _mm512_mul_ps(va, vb), a[i] * b[i])
+SIMD_BINOP_KERNEL(avx512RealDivide, "avx512f", __m512, 16, float, float, AVX512_LOADF, AVX512_STOREF,
+                  _mm512_div_ps(va, vb), a[i] / b[i])
+SIMD_BINOP_KERNEL(avx512RealLT, "avx512f", __m512, 16, float, bool, AVX512_LOADF, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmp_ps_mask(va, vb, _CMP_LT_OQ)), a[i] < b[i])
+SIMD_BINOP_KERNEL(avx512RealBT, "avx512f", __m512, 16, float, bool, AVX512_LOADF, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmp_ps_mask(va, vb, _CMP_GT_OQ)), a[i] > b[i])
+SIMD_BINOP_KERNEL(avx512RealLEQ, "avx512f", __m512, 16, float, bool, AVX512_LOADF, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmp_ps_mask(va, vb, _CMP_LE_OQ)), a[i] <= b[i])
+SIMD_BINOP_KERNEL(avx512RealBEQ, "avx512f", __m512, 16, float, bool, AVX512_LOADF, AVX512_STOREI,
+                  AVX512_MASK_TO_BOOL(_mm512_cmp_ps_mask(va, vb, _CMP_GE_OQ)), a[i] >= b[i])
+
+__attribute__((target("avx512f")))
+int32_t avx512IntegerDotProduct(const int32_t *a, const int32_t *b, int64_t size) {
+    __m512i sum = _mm512_setzero_si512();
+    int64_t i = 0;
+    for (; i + 16 <= size; i += 16)
+        sum = _mm512_add_epi32(sum, _mm512_mullo_epi32(AVX512_LOADI(a + i), AVX512_LOADI(b + i)));
+    uint32_t total = (uint32_t)_mm512_reduce_add_epi32(sum);
+    for (; i < size; i++)
+        total += (uint32_t)a[i] * (uint32_t)b[i];
+    return (int32_t)total;
+}
+
+__attribute__((target("avx512f")))
+float avx512RealDotProduct(const float *a, const float *b, int64_t size) {
+    __m512 sum = _mm512_setzero_ps();
+    int64_t i = 0;
+    for (; i + REAL_DOT_LANES <= size; i += REAL_DOT_LANES)
+        sum = _mm512_add_ps(sum, _mm512_mul_ps(AVX512_LOADF(a + i), AVX512_LOADF(b + i)));
+    float lanes[REAL_DOT_LANES];
+    AVX512_STOREF(lanes, sum);  // not _mm512_reduce_add_ps, its fold order is up to the compiler
+    return realDotFoldLanes(lanes, a, b, i, size);
+}
+
+__attribute__((target("avx512f")))
+void avx512IntegerAxpy(int32_t *y, const int32_t *x, int32_t a, int64_t size) {
+    __m512i va = _mm512_set1_epi32(a);
+    int64_t i = 0;
+    for (; i + 16 <= size; i += 16)
+        AVX512_STOREI(y + i, _mm512_add_epi32(AVX512_LOADI(y + i), _mm512_mullo_epi32(va, AVX512_LOADI(x + i))));
+    scalarIntegerAxpy(y + i, x + i, a, size - i);
+}
+
+__attribute__((target("avx512f")))
+void avx512RealAxpy(float *y, const float *x, float a, int64_t size) {
+    __m512 va = _mm512_set1_ps(a);
+    int64_t i = 0;
+    for (; i + 16 <= size; i += 16)
+        AVX512_STOREF(y + i, _mm512_add_ps(AVX512_LOADF(y + i), _mm512_mul_ps(va, AVX512_LOADF(x + i))));
+    scalarRealAxpy(y + i, x + i, a, size - i);
+}
+
+///------------------------------DISPATCH---------------------------------------------------------------
+
+#define SIMD_KERNEL_TABLE(prefix)                                   \
+    {                                                               \
+        [BINARY_MULTIPLY] = prefix##IntegerMultiply,                \
+        [BINARY_PLUS] = prefix##IntegerPlus,                        \
+        [BINARY_MINUS] = prefix##IntegerMinus,                      \
+        [BINARY_LT] = prefix##IntegerLT,                            \
+        [BINARY_BT] = prefix##IntegerBT,                            \
+        [BINARY_LEQ] = prefix##IntegerLEQ,                          \
+        [BINARY_BEQ] = prefix##IntegerBEQ,                          \
+    },                                                              \
+    {                                                               \
+        [BINARY_MULTIPLY] = prefix##RealMultiply,                   \
+        [BINARY_DIVIDE] = prefix##RealDivide,                       \
+        [BINARY_PLUS] = prefix##RealPlus,                           \
+        [BINARY_MINUS] = prefix##RealMinus,                         \
+        [BINARY_LT] = prefix##RealLT,                               \
+        [BINARY_BT] = prefix##RealBT,                               \
+        [BINARY_LEQ] = prefix##RealLEQ,                             \
+        [BINARY_BEQ] = prefix##RealBEQ,                             \
+    }
+
+// [level][0 for integer, 1 for real][opcode]
+ArrayBinOpKernel simdBinOpKernels[SIMD_AVX512 + 1][2][NUM_BINARY_OPS] = {
+    [SIMD_SSE2] = { SIMD_KERNEL_TABLE(sse2) },
+    [SIMD_AVX2] = { SIMD_KERNEL_TABLE(avx2) },
+    [SIMD_AVX512] = { SIMD_KERNEL_TABLE(avx512) },
+};
+
+SIMDLevel arraySIMDDetectLevel() {
+    __builtin_cpu_init();
+    SIMDLevel level = SIMD_NONE;
+    if (__builtin_cpu_supports("avx512f"))
+        level = SIMD_AVX512;
+    else if (__builtin_cpu_supports("avx2"))
+        level = SIMD_AVX2;
+    else if (__builtin_cpu_supports("sse2"))
+        level = SIMD_SSE2;
+
+    // the override can only lower the level, never enable an instruction set the cpu lacks
+    char *override = getenv("GAZRT_SIMD");
+    if (override != NULL) {
+        SIMDLevel requested = level;
+        if (strcmp(override, "none") == 0)
+            requested = SIMD_NONE;
+        else if (strcmp(override, "sse2") == 0)
+            requested = SIMD_SSE2;
+        else if (strcmp(override, "avx2") == 0)
+            requested = SIMD_AVX2;
+        else if (strcmp(override, "avx512") == 0)
+            requested = SIMD_AVX512;
+        if (requested < level)
+            level = requested;
+    }
+    return level;
+}
+
+static SIMDLevel arraySIMDLevel = SIMD_NONE;
+static pthread_once_t arraySIMDLevelOnce = PTHREAD_ONCE_INIT;
+
+void arraySIMDInitLevel() {
+    arraySIMDLevel = arraySIMDDetectLevel();
+}
+
+SIMDLevel arraySIMDGetLevel() {
+    pthread_once(&arraySIMDLevelOnce, arraySIMDInitLevel);  // kernels may ask for the level from worker threads
+    return arraySIMDLevel;
+}
+
+ArrayBinOpKernel arraySIMDGetBinOpKernel(ElementTypeID id, BinOpCode opcode) {
+    SIMDLevel level = arraySIMDGetLevel();
+    if (level == SIMD_NONE)
+        return NULL;
+    switch (id) {
+        case ELEMENT_INTEGER:
+            return simdBinOpKernels[level][0][opcode];
+        case ELEMENT_REAL:
+            return simdBinOpKernels[level][1][opcode];
+        default:
+            return NULL;
+    }
+}
+
+int32_t arraySIMDIntegerDotProduct(const int32_t *op1, const int32_t *op2, int64_t size) {
+    switch (arraySIMDGetLevel()) {
+        case SIMD_AVX512:
+            return avx512IntegerDotProduct(op1, op2, size);
+        case SIMD_AVX2:
+            return avx2IntegerDotProduct(op1, op2, size);
+        case SIMD_SSE2:
+            return sse2IntegerDotProduct(op1, op2, size);
+        default:
+            break;
+    }
+    uint32_t total = 0;
+    for (int64_t i = 0; i < size; i++)
+        total += (uint32_t)op1[i] * (uint32_t)op2[i];
+    return (int32_t)total;
+}
+
+float arraySIMDRealDotProduct(const float *op1, const float *op2, int64_t size) {
+    switch (arraySIMDGetLevel()) {
+        case SIMD_AVX512:
+            return avx512RealDotProduct(op1, op2, size);
+        case SIMD_AVX2:
+            return avx2RealDotProduct(op1, op2, size);
+        case SIMD_SSE2:
+            return sse2RealDotProduct(op1, op2, size);
+        default:
+            return scalarRealDotProduct(op1, op2, size);
+    }
+}
+
+ArrayIntegerAxpyKernel arraySIMDGetIntegerAxpy() {
+    switch (arraySIMDGetLevel()) {
+        case SIMD_AVX512:
+            return avx512IntegerAxpy;
+        case SIMD_AVX2:
+            return avx2IntegerAxpy;
+        case SIMD_SSE2:
+            return sse2IntegerAxpy;
+        default:
+            return scalarIntegerAxpy;
+    }
+}
+
+ArrayRealAxpyKernel arraySIMDGetRealAxpy() {
+    switch (arraySIMDGetLevel()) {
+        case SIMD_AVX512:
+            return avx512RealAxpy;
+        case SIMD_AVX2:
+            return avx2RealAxpy;
+        case SIMD_SSE2:
+            return sse2RealAxpy;
+        default:
+            return scalarRealAxpy;
+    }
+}
+
+#else  // no SIMD kernels outside x86
+
+SIMDLevel arraySIMDGetLevel() {
+    return SIMD_NONE;
+}
+
+ArrayBinOpKernel arraySIMDGetBinOpKernel(ElementTypeID id, BinOpCode opcode) {
+    return NULL;
+}
+
+int32_t arraySIMDIntegerDotProduct(const int32_t *op1, const int32_t *op2, int64_t size) {
+    uint32_t total = 0;
+    for (int64_t i = 0; i < size; i++)
+        total += (uint32_t)op1[i] * (uint32_t)op2[i];
+    return (int32_t)total;
+}
+
+float arraySIMDRealDotProduct(const float *op1, const float *op2, int64_t size) {
+    return scalarRealDotProduct(op1, op2, size);
+}
+
+ArrayIntegerAxpyKernel arraySIMDGetIntegerAxpy() {
+    return scalarIntegerAxpy;
+}
+
+ArrayRealAxpyKernel arraySIMDGetRealAxpy() {
+    return scalarRealAxpy;
+}
+
+#endif
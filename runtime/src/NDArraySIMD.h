@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * Hand vectorized kernels for the element-wise binary ops and the dot products of NDArray.c
+ * The widest instruction set the cpu supports (SSE2, AVX2 or AVX-512) is picked with cpuid the first time a kernel is
+ * requested; set the environment variable GAZRT_SIMD to sse2, avx2, avx512 or none to override the choice
+ * On non-x86 targets there are no SIMD kernels and NDArray.c keeps using its scalar kernels
+ */
+
+#include <stdint.h>
+#include "Bool.h"
+#include "Enums.h"
+
+typedef enum enum_gazprea_simd_level {
+    SIMD_NONE,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_AVX512,
+} SIMDLevel;
+
+// computes op1[i] <op> op2[i] for i in [0, size) into result
+typedef void (*ArrayBinOpKernel)(void *op1, void *op2, void *result, int64_t size);
+
+SIMDLevel arraySIMDGetLevel();
+ArrayBinOpKernel arraySIMDGetBinOpKernel(ElementTypeID id, BinOpCode opcode);  // returns NULL if there is no SIMD kernel
+int32_t arraySIMDIntegerDotProduct(const int32_t *op1, const int32_t *op2, int64_t size);
+// sums 16 fixed lanes folded pairwise at every SIMD level (see NDArraySIMD.c) so the result does not depend on the
+// level picked, with GAZRT_SIMD=none (or off x86) it is the in order loop
+float arraySIMDRealDotProduct(const float *op1, const float *op2, int64_t size);
+
+// y[i] += a * x[i], the inner update of the matrix multiplication
+typedef void (*ArrayIntegerAxpyKernel)(int32_t *y, const int32_t *x, int32_t a, int64_t size);
+typedef void (*ArrayRealAxpyKernel)(float *y, const float *x, float a, int64_t size);
+ArrayIntegerAxpyKernel arraySIMDGetIntegerAxpy();
+ArrayRealAxpyKernel arraySIMDGetRealAxpy();
@@ -28,6 +28,12 @@ void arrayTypeInitFromCopy(ArrayType *this, ArrayType *other) {
 void arrayTypeInitFromCopyByRef(ArrayType *this, ArrayType *other) {
     arrayTypeInitFromDims(this, other->m_elementTypeID, other->m_nDim, other->m_dims,
                           other->m_isString, other->m_refCount, other->m_isRef, other->m_isSelfRef);
+    this->m_shareCount = other->m_shareCount;
+    this->m_owner = other->m_owner;
+    this->m_isLiteral = other->m_isLiteral;
+    this->m_viewOffset = other->m_viewOffset;
+    this->m_viewStrides[0] = other->m_viewStrides[0];
+    this->m_viewStrides[1] = other->m_viewStrides[1];
 }
 
 void arrayTypeInitFromDims(ArrayType *this, ElementTypeID elementTypeID, int8_t nDim, int64_t *dims,
@@ -44,27 +50,48 @@ void arrayTypeInitFromDims(ArrayType *this, ElementTypeID elementTypeID, int8_t
     } else
         this->m_dims = NULL;
 
+    this->m_shareCount = NULL;
     if (refCount != NULL)  {
         this->m_refCount = refCount;
         arrayTypeIncReferenceCount(this);
     } else {
         this->m_refCount = malloc(sizeof(int32_t));
         *this->m_refCount = 1;
+        if (nDim != 0 && nDim != DIM_UNSPECIFIED) {
+            this->m_shareCount = malloc(sizeof(int32_t));
+            *this->m_shareCount = 1;
+        }
     }
+    this->m_owner = NULL;
+    this->m_viewOffset = -1;
+    this->m_viewStrides[0] = 0;
+    this->m_viewStrides[1] = 0;
 #ifdef DEBUG_PRINT
     fprintf(stderr, "rc:%p->%d\n", this->m_refCount, *this->m_refCount);
 #endif
 
     this->m_isRef = isRef;
     this->m_isSelfRef = isSelfRef;
+    this->m_isLiteral = false;
 }
 
-void arrayTypeDestructor(ArrayType *this) {
-    if (arrayTypeGetReferenceCount(this) <= 1) {
-        free(this->m_refCount);
-    } else {
+// drop this type's claim on m_data; the buffer itself is freed by the caller
+void arrayTypeReleaseBuffer(ArrayType *this) {
+    if (arrayTypeGetReferenceCount(this) > 1) {
         arrayTypeDecReferenceCount(this);
+        return;
     }
+    free(this->m_refCount);
+    if (this->m_shareCount != NULL) {
+        if (*this->m_shareCount <= 1)
+            free(this->m_shareCount);
+        else
+            (*this->m_shareCount)--;
+    }
+}
+
+void arrayTypeDestructor(ArrayType *this) {
+    arrayTypeReleaseBuffer(this);
     free(this->m_dims);
 }
 
@@ -82,6 +109,16 @@ void arrayTypeIncReferenceCount(ArrayType *this) {
     (*this->m_refCount)++;
 }
 
+bool arrayTypeIsLastBufferReference(ArrayType *this) {
+    return arrayTypeGetReferenceCount(this) <= 1 && (this->m_shareCount == NULL || *this->m_shareCount <= 1);
+}
+
+void arrayTypeShareBuffer(ArrayType *this, ArrayType *other) {
+    free(this->m_shareCount);
+    this->m_shareCount = other->m_shareCount;
+    (*this->m_shareCount)++;
+}
+
 VecToVecRHSSizeRestriction arrayTypeMinimumCompatibleRestriction(ArrayType *this, ArrayType *target) {
     VecToVecRHSSizeRestriction compatibleRestriction = vectovec_rhs_must_be_same_size;
 
@@ -332,6 +369,120 @@ NDArrayTypeID typeGetNDArrayTypeID(Type *this) {
 
 ///------------------------------Variable---------------------------------------------------------------
 
+// the copy of the indexed array behind an index reference remembers the indexed variable, so a write through the
+// reference can detach that variable from its copy-on-write buffer; a temporary conversion of arr has no owner
+void ndarrayRefCloneSetOwner(Variable *clone, Variable *pop, Variable *arr) {
+    ArrayType *CTI = clone->m_type->m_compoundTypeInfo;
+    CTI->m_owner = pop == arr ? arr : NULL;
+}
+
+// true if a 1-based integer index is a scalar or an arithmetic sequence within [1, bound]
+// sets first to its first 0-based position and step to the distance between consecutive positions
+bool ndarrayIndexIsArithmeticSequence(Variable *index, int64_t bound, int64_t *first, int64_t *step) {
+    int32_t *positions = index->m_data;
+    int64_t len = variableGetNDim(index) == 0 ? 1 : variableGetLength(index);
+    if (len == 0)
+        return false;
+    *first = positions[0] - 1;
+    *step = len == 1 ? 0 : (int64_t)positions[1] - positions[0];
+    for (int64_t i = 2; i < len; i++) {
+        if ((int64_t)positions[i] - positions[i - 1] != *step)
+            return false;
+    }
+    int64_t last = *first + (len - 1) * *step;
+    return *first >= 0 && *first < bound && last >= 0 && last < bound;
+}
+
+// turn a vector or matrix index reference into a strided view if every index is an in-range arithmetic sequence;
+// out of range indices keep the reference a plain one so the error is still raised on access
+void ndarrayRefInitStridedView(Variable *this) {
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    NDArrayIndexRefTypeID id = variableGetIndexRefTypeID(this);
+    if (id != NDARRAY_INDEX_REF_1D && id != NDARRAY_INDEX_REF_2D)
+        return;
+    Variable **vars = this->m_data;
+    ArrayType *selfCTI = vars[0]->m_type->m_compoundTypeInfo;
+    if (selfCTI->m_isRef || !elementIsBasicType(selfCTI->m_elementTypeID))
+        return;
+
+    int64_t rowFirst, rowStep, colFirst = 0, colStep = 0;
+    int64_t nCol = id == NDARRAY_INDEX_REF_2D ? selfCTI->m_dims[1] : 1;
+    if (!ndarrayIndexIsArithmeticSequence(vars[1], selfCTI->m_dims[0], &rowFirst, &rowStep))
+        return;
+    if (id == NDARRAY_INDEX_REF_2D && !ndarrayIndexIsArithmeticSequence(vars[2], nCol, &colFirst, &colStep))
+        return;
+
+    // a scalar index does not add a dimension to the reference
+    int8_t dim = 0;
+    if (variableGetNDim(vars[1]) == 1)
+        CTI->m_viewStrides[dim++] = rowStep * nCol;
+    if (id == NDARRAY_INDEX_REF_2D && variableGetNDim(vars[2]) == 1)
+        CTI->m_viewStrides[dim++] = colStep;
+    CTI->m_viewOffset = rowFirst * nCol + colFirst;
+}
+
+// position in the indexed array of element pos of a strided view
+int64_t ndarrayStridedViewPosition(ArrayType *CTI, int64_t pos) {
+    switch (CTI->m_nDim) {
+        case 0:
+            return CTI->m_viewOffset;
+        case 1:
+            return CTI->m_viewOffset + pos * CTI->m_viewStrides[0];
+        default: {
+            int64_t nCol = CTI->m_dims[1];
+            return CTI->m_viewOffset + pos / nCol * CTI->m_viewStrides[0] + pos % nCol * CTI->m_viewStrides[1];
+        }
+    }
+}
+
+bool variableNDArrayIsStridedView(Variable *this) {
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    return CTI->m_isRef && CTI->m_viewOffset >= 0;
+}
+
+// copy between the rows of a strided view and a packed buffer, one typed loop per element size so it vectorizes
+#define STRIDED_VIEW_COPY(ctype, view, packed, toView, nRow, nCol, rowStride, colStride) do { \
+    ctype *v = (ctype *)(view); \
+    ctype *p = (ctype *)(packed); \
+    for (int64_t i = 0; i < (nRow); i++) { \
+        ctype *viewRow = v + i * (rowStride); \
+        ctype *packedRow = p + i * (nCol); \
+        if (toView) { \
+            for (int64_t j = 0; j < (nCol); j++) \
+                viewRow[j * (colStride)] = packedRow[j]; \
+        } else { \
+            for (int64_t j = 0; j < (nCol); j++) \
+                packedRow[j] = viewRow[j * (colStride)]; \
+        } \
+    } \
+} while (0)
+
+void ndarrayStridedViewCopy(Variable *view, void *packed, bool toView) {
+    ArrayType *CTI = view->m_type->m_compoundTypeInfo;
+    Variable **vars = view->m_data;
+    ElementTypeID eid = CTI->m_elementTypeID;
+    void *first = arrayGetElementPtrAtIndex(eid, vars[0]->m_data, CTI->m_viewOffset);
+
+    // a vector is a single row and a scalar a single element
+    int64_t nRow = CTI->m_nDim == 2 ? CTI->m_dims[0] : 1;
+    int64_t nCol = CTI->m_nDim == 0 ? 1 : CTI->m_dims[CTI->m_nDim - 1];
+    int64_t rowStride = CTI->m_nDim == 2 ? CTI->m_viewStrides[0] : 0;
+    int64_t colStride = CTI->m_viewStrides[CTI->m_nDim == 2 ? 1 : 0];
+    if (elementGetSize(eid) == sizeof(int32_t)) {
+        STRIDED_VIEW_COPY(int32_t, first, packed, toView, nRow, nCol, rowStride, colStride);
+    } else {
+        STRIDED_VIEW_COPY(int8_t, first, packed, toView, nRow, nCol, rowStride, colStride);
+    }
+}
+
+void ndarrayStridedViewGather(Variable *view, void *dst) {
+    ndarrayStridedViewCopy(view, dst, false);
+}
+
+void ndarrayStridedViewScatter(Variable *view, void *src) {
+    ndarrayStridedViewCopy(view, src, true);
+}
+
 void variableInitFromArrayIndexingHelper(Variable *this, Variable *arr, Variable *rowIndex, Variable *colIndex, int64_t nIndex) {
     Type *arrType = arr->m_type;
     Type *rowIndexType = rowIndex->m_type;
@@ -401,6 +552,7 @@ void variableInitFromArrayIndexingHelper(Variable *this, Variable *arr, Variable
         Variable **vars = malloc(sizeof(Variable *));
         vars[0] = variableMalloc();
         variableInitFromNDArrayCopyByRef(vars[0], pop1);
+        ndarrayRefCloneSetOwner(vars[0], pop1, arr);
         this->m_data = vars;
         variableAttrInitHelper(this, pop1->m_fieldPos, pop1->m_parent, false);
     } else {
@@ -520,6 +672,7 @@ void variableInitFromArrayIndexingHelper(Variable *this, Variable *arr, Variable
                     else {  // matrix
                         tempDims[0] = pop2CTI->m_dims[0];
                         tempDims[1] = pop3CTI->m_dims[0];
+                        resultDims = tempDims;
                     }
                 }
 
@@ -536,7 +689,7 @@ void variableInitFromArrayIndexingHelper(Variable *this, Variable *arr, Variable
                 Variable *temp1 = variableMalloc();
                 Variable *temp2 = variableMalloc();
                 variableInitFromArrayIndexingHelper(temp1, pop1Vars[1], pop2, NULL, 1);
-                variableInitFromArrayIndexingHelper(temp2, pop1Vars[2], pop2, NULL, 1);
+                variableInitFromArrayIndexingHelper(temp2, pop1Vars[2], pop3, NULL, 1);
                 variableInitFromNDArrayIndexRefToValue(vars[1], temp1);
                 variableInitFromNDArrayIndexRefToValue(vars[2], temp2);
 #ifdef DEBUG_PRINT
@@ -572,6 +725,7 @@ void variableInitFromArrayIndexingHelper(Variable *this, Variable *arr, Variable
                 // the ownership is determined by whether the self array is blocked scoped or a temporary vector
                 Variable *newSelf = variableMalloc();
                 variableInitFromNDArrayCopyByRef(newSelf, pop1);
+                ndarrayRefCloneSetOwner(newSelf, pop1, arr);
                 typeInitFromNDArray(this->m_type, pop1CTI->m_elementTypeID, resultNDim, resultDims,
                                     pop1CTI->m_isString && resultNDim == 1, NULL, true, false);
                 vars = malloc(sizeof(Variable *) * 2);
@@ -597,6 +751,7 @@ void variableInitFromArrayIndexingHelper(Variable *this, Variable *arr, Variable
 
                 Variable *newSelf = variableMalloc();
                 variableInitFromNDArrayCopyByRef(newSelf, pop1);
+                ndarrayRefCloneSetOwner(newSelf, pop1, arr);
                 typeInitFromNDArray(this->m_type, pop1CTI->m_elementTypeID, resultNDim, tempDims,
                                     false, NULL, true, false);
                 vars = malloc(sizeof(Variable *) * 3);
@@ -608,6 +763,7 @@ void variableInitFromArrayIndexingHelper(Variable *this, Variable *arr, Variable
 
         this->m_data = vars;
         variableAttrInitHelper(this, pop1->m_fieldPos, pop1->m_parent, false);
+        ndarrayRefInitStridedView(this);
     }
 #ifdef DEBUG_PRINT
     variableInitDebugPrint(this, "array index");
@@ -632,10 +788,14 @@ void variableInitFromNDArrayIndexRefToValue(Variable *this, Variable *ref) {
     this->m_data = arrayMallocFromNull(eid, len);
     variableAttrInitHelper(this, -1, this->m_data, false);
 
-    for (int64_t i = 0; i < len; i++) {
-        void *srcPtr = variableNDArrayGet(ref, i);
-        void *targetPtr = variableNDArrayGet(this, i);
-        elementAssign(eid, targetPtr, srcPtr);
+    if (variableNDArrayIsStridedView(ref)) {
+        ndarrayStridedViewGather(ref, this->m_data);
+    } else {
+        for (int64_t i = 0; i < len; i++) {
+            void *srcPtr = variableNDArrayGet(ref, i);
+            void *targetPtr = variableNDArrayGet(this, i);
+            elementAssign(eid, targetPtr, srcPtr);
+        }
     }
 
 #ifdef DEBUG_PRINT
@@ -683,7 +843,7 @@ void variableNDArrayDestructor(Variable *this) {
             }
         } break;
         case NDARRAY_INDEX_REF_NOT_A_REF: {
-            if (arrayTypeGetReferenceCount(CTI) <= 1) {
+            if (arrayTypeIsLastBufferReference(CTI)) {
                 arrayFree(CTI->m_elementTypeID, this->m_data, arrayTypeGetTotalLength(CTI));
             }
         } break;
@@ -699,9 +859,17 @@ void variableInitFromNDArrayCopy(Variable *this, Variable *other) {
         ArrayType *otherCTI = other->m_type->m_compoundTypeInfo;
         this->m_type = typeMalloc();
         typeInitFromCopy(this->m_type, other->m_type);
-        this->m_data = arrayMallocFromMemcpy(otherCTI->m_elementTypeID, arrayTypeGetTotalLength(otherCTI),
-                                             other->m_data);
-        variableAttrInitHelper(this, -1, this->m_data, false);
+        ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+        if (otherCTI->m_shareCount != NULL && elementIsBasicType(otherCTI->m_elementTypeID)) {
+            // copy-on-write, the type is the parent so the copy does not alias the original
+            arrayTypeShareBuffer(CTI, otherCTI);
+            this->m_data = other->m_data;
+            variableAttrInitHelper(this, -1, CTI, false);
+        } else {
+            this->m_data = arrayMallocFromMemcpy(otherCTI->m_elementTypeID, arrayTypeGetTotalLength(otherCTI),
+                                                 other->m_data);
+            variableAttrInitHelper(this, -1, this->m_data, false);
+        }
     } else {
         variableInitFromNDArrayIndexRefToValue(this, other);
     }
@@ -749,7 +917,9 @@ void *ndarrayRefElementPtrGetter(Variable *this, int64_t pos) {
 
     Variable **vars = this->m_data;
     Variable *self = vars[0];
-    if (CTI->m_isSelfRef) {
+    if (CTI->m_viewOffset >= 0) {
+        return arrayGetElementPtrAtIndex(CTI->m_elementTypeID, self->m_data, ndarrayStridedViewPosition(CTI, pos));
+    } else if (CTI->m_isSelfRef) {
         int32_t selfIndex = variableGetIntegerElementAtIndex(self, pos) - 1;
         return variableNDArrayGet(self, selfIndex);
     } else {  // can be a vector or a matrix
@@ -794,7 +964,50 @@ void *variableNDArrayCopyGet(Variable *this, int64_t pos) {
     void *result = arrayMallocFromElementValue(CTI->m_elementTypeID, 1, target);
 }
 
+void variableNDArrayDetach(Variable *this) {
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    if (CTI->m_isRef || CTI->m_shareCount == NULL || *CTI->m_shareCount <= 1)
+        return;
+    void *shared = this->m_data;
+    arrayTypeReleaseBuffer(CTI);  // never the last claim since the buffer is shared
+    CTI->m_refCount = malloc(sizeof(int32_t));
+    *CTI->m_refCount = 1;
+    CTI->m_shareCount = malloc(sizeof(int32_t));
+    *CTI->m_shareCount = 1;
+    this->m_data = arrayMallocFromMemcpy(CTI->m_elementTypeID, arrayTypeGetTotalLength(CTI), shared);
+    if (this->m_parent == shared)
+        this->m_parent = this->m_data;
+}
+
+void variableNDArrayPrepareWrite(Variable *this) {
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    if (!CTI->m_isRef) {
+        variableNDArrayDetach(this);
+        return;
+    }
+    Variable *root = variableNDArrayIndexRefGetRootVariable(this);
+    ArrayType *rootCTI = root->m_type->m_compoundTypeInfo;
+    if (rootCTI->m_shareCount == NULL || *rootCTI->m_shareCount <= 1)
+        return;
+    Variable *owner = rootCTI->m_owner;
+    if (owner == NULL || owner->m_data != root->m_data) {
+        // nothing else sees writes through this reference
+        variableNDArrayDetach(root);
+        return;
+    }
+    // the indexed variable takes a private buffer and the reference follows it there
+    variableNDArrayDetach(owner);
+    ArrayType *ownerCTI = owner->m_type->m_compoundTypeInfo;
+    arrayTypeReleaseBuffer(rootCTI);
+    rootCTI->m_refCount = ownerCTI->m_refCount;
+    rootCTI->m_shareCount = ownerCTI->m_shareCount;
+    arrayTypeIncReferenceCount(rootCTI);
+    root->m_data = owner->m_data;
+    root->m_parent = owner->m_parent;
+}
+
 void variableNDArraySet(Variable *this, int64_t pos, void *val) {
+    variableNDArrayPrepareWrite(this);
     void *target = variableNDArrayGet(this, pos);
     ArrayType *CTI = this->m_type->m_compoundTypeInfo;
     elementAssign(CTI->m_elementTypeID, target, val);
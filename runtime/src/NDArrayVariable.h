@@ -10,18 +10,29 @@
  * - isSelfRef = false
  * - elementTypeID = ELEMENT_MIXED
  * An empty array is a mixed type array with 0 size and nDim=DIM_UNSPECIFIED
+ * A vector literal whose elements all share one basic type is instead stored packed with that element type and
+ * isLiteral = true, which lets it convert to other element types the same way a mixed array does
  *
  * 2. A concrete array is an array that is not a reference nor a literal
  * - isRef = false
  * - isSelfRef = false
  * - elementTypeID != ELEMENT_MIXED
  *
+ * Copying a concrete vector or matrix of a basic element type shares m_data copy-on-write instead of duplicating it
+ * - all copies of a buffer share m_shareCount, and each copy and the index references taken from it share m_refCount
+ * - a write through variableNDArraySet() or an index assignment first gives the written variable a private buffer
+ *
  * 3. A reference array to one (self-indexed), two(vector) or three(matrix) other array variables
  * - isRef = true
  * - isSelfRef can be true or false
  * - elementTypeID != ELEMENT_MIXED  // a reference can't be a literal or reference to a literal
  * More specifically, a reference array can only reference to concrete array type described in 2)
  * Note 2) and 3) can be string but an array literal is never a string
+ *
+ * A vector or matrix reference whose indices are each a scalar or an in-range arithmetic sequence, e.g. v[2..n] or
+ * m[1..3, 4..6], is also a strided view: element pos of the reference is at
+ * m_viewOffset + row * m_viewStrides[0] + col * m_viewStrides[1] in the indexed array, so element access and the copies
+ * in and out of the reference need not look up the index vectors
  */
 
 #include <stdint.h>
@@ -38,9 +49,14 @@ typedef struct struct_gazprea_array_type {
     int8_t m_nDim;                  // # of dimensions
     int64_t *m_dims;                // each int64_t specify the length of array in one dimension
     int32_t *m_refCount;              // the number of times m_data is pointed to; determines if we are able to free m_data in destructor
+    int32_t *m_shareCount;            // the number of copy-on-write owners of m_data, each with its own m_refCount; NULL for scalars
+    Variable *m_owner;                // for the array behind an index reference, the variable that was indexed or NULL
+    int64_t m_viewOffset;             // for a strided view index reference, position of its first element in the indexed array; -1 otherwise
+    int64_t m_viewStrides[2];         // for a strided view index reference, distance between elements along each of its dimensions
     bool m_isString;
     bool m_isRef;                     // if the array is index reference, default to false
     bool m_isSelfRef;                 // if the array is indexed by itself E.g. a[a], default to false
+    bool m_isLiteral;                 // if the array is a packed homogeneous literal, default to false
 } ArrayType;
 
 /// allocate
@@ -59,6 +75,8 @@ void arrayTypeDestructor(ArrayType *this);
 int32_t arrayTypeGetReferenceCount(ArrayType *this);
 void arrayTypeDecReferenceCount(ArrayType *this);
 void arrayTypeIncReferenceCount(ArrayType *this);
+bool arrayTypeIsLastBufferReference(ArrayType *this);  // true if no other type points to m_data
+void arrayTypeShareBuffer(ArrayType *this, ArrayType *other);  // this, a freshly initialized type, becomes a copy-on-write owner of other's buffer
 VecToVecRHSSizeRestriction arrayTypeMinimumCompatibleRestriction(ArrayType *this, ArrayType *target);
 bool arrayTypeHasUnknownSize(ArrayType *this);
 int64_t arrayTypeElementSize(ArrayType *this);
@@ -101,7 +119,12 @@ void variableNDArrayDestructor(Variable *this);  // called in variableFree()
 
 void variableInitFromNDArrayCopy(Variable *this, Variable *other);
 void variableInitFromNDArrayCopyByRef(Variable *this, Variable *other);
+void variableNDArrayDetach(Variable *this);  // give a concrete array whose buffer is shared copy-on-write a private copy
+void variableNDArrayPrepareWrite(Variable *this);  // make writes through this array or index reference invisible to other copies
 Variable *variableNDArrayIndexRefGetRootVariable(Variable *indexRef);
+bool variableNDArrayIsStridedView(Variable *this);
+void ndarrayStridedViewGather(Variable *view, void *dst);  // copy the elements of a strided view to a packed buffer
+void ndarrayStridedViewScatter(Variable *view, void *src);  // copy a packed buffer to the elements of a strided view
 
 void *variableNDArrayGet(Variable *this, int64_t pos);
 void *variableNDArrayCopyGet(Variable *this, int64_t pos);
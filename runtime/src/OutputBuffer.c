@@ -0,0 +1,235 @@
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "OutputBuffer.h"
+
+static char outputBufferStdoutData[OUTPUT_BUFFER_CAPACITY];
+static OutputBuffer outputBufferStdoutBuffer = {
+    STDOUT_FILENO, 0, OUTPUT_BUFFER_CAPACITY, outputBufferStdoutData
+};
+static int outputBufferStdoutRegistered = 0;
+static int outputBufferStdoutIsTerminal = -1;  // -1 until checked
+
+void outputBufferInit(OutputBuffer *this, int fd, char *data, int64_t capacity) {
+    this->m_fd = fd;
+    this->m_size = 0;
+    this->m_capacity = capacity;
+    this->m_data = data;
+}
+
+void outputBufferFlushStdout() {
+    outputBufferFlush(&outputBufferStdoutBuffer);
+}
+
+OutputBuffer *outputBufferStdout() {
+    if (!outputBufferStdoutRegistered) {
+        outputBufferStdoutRegistered = 1;
+        atexit(outputBufferFlushStdout);  // exit() is also how runtime errors end the program
+    }
+    return &outputBufferStdoutBuffer;
+}
+
+void outputBufferFlush(OutputBuffer *this) {
+    int64_t written = 0;
+    while (written < this->m_size) {
+        ssize_t n = write(this->m_fd, this->m_data + written, this->m_size - written);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            break;  // the output is gone, drop what is left like stdio does
+        }
+        written += n;
+    }
+    this->m_size = 0;
+}
+
+// stdio flushes a line buffered (terminal) stdout before reading, do the same so prompts show up
+void outputBufferFlushStdoutIfInteractive() {
+    if (outputBufferStdoutBuffer.m_size == 0)
+        return;
+    if (outputBufferStdoutIsTerminal == -1)
+        outputBufferStdoutIsTerminal = isatty(STDOUT_FILENO);
+    if (outputBufferStdoutIsTerminal)
+        outputBufferFlush(&outputBufferStdoutBuffer);
+}
+
+void outputBufferReserve(OutputBuffer *this, int64_t n) {
+    if (this->m_size + n > this->m_capacity)
+        outputBufferFlush(this);
+}
+
+void outputBufferWriteChar(OutputBuffer *this, char ch) {
+    outputBufferReserve(this, 1);
+    this->m_data[this->m_size++] = ch;
+}
+
+void outputBufferWriteBytes(OutputBuffer *this, const char *bytes, int64_t n) {
+    while (n > 0) {
+        outputBufferReserve(this, n < this->m_capacity ? n : this->m_capacity);
+        int64_t chunk = this->m_capacity - this->m_size;
+        if (chunk > n)
+            chunk = n;
+        memcpy(this->m_data + this->m_size, bytes, chunk);
+        this->m_size += chunk;
+        bytes += chunk;
+        n -= chunk;
+    }
+}
+
+///------------------------------NUMBER FORMATTING---------------------------------------------------------------
+
+// writes the decimal digits of value, which has exactly nDigit of them
+void formatDigits(char *dst, uint64_t value, int nDigit) {
+    for (int i = nDigit - 1; i >= 0; i--) {
+        dst[i] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+int formatInteger(char *dst, int32_t value) {
+    char *pos = dst;
+    int64_t magnitude = value;
+    if (magnitude < 0) {
+        *pos++ = '-';
+        magnitude = -magnitude;
+    }
+    int nDigit = 1;
+    for (int64_t rest = magnitude; rest >= 10; rest /= 10)
+        nDigit++;
+    formatDigits(pos, magnitude, nDigit);
+    return (int)(pos - dst) + nDigit;
+}
+
+unsigned __int128 formatPowerOfTen(int k) {  // k <= 38
+    unsigned __int128 result = 1;
+    for (; k >= 19; k -= 19)
+        result *= (uint64_t)10000000000000000000ULL;
+    static const uint64_t small[19] = {
+        1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+        10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+        1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL
+    };
+    return result * small[k];
+}
+
+/**
+ * Exactly computes floor(m * 2^e * 10^k) into *floorResult and compares the dropped fraction with one half,
+ * *fraction is -1 if it is smaller, 0 if it is exactly one half and 1 if it is larger
+ * Returns false if the computation does not fit in 128 bit integers
+ */
+bool formatScaleExact(uint32_t m, int e, int k, uint64_t *floorResult, int *fraction) {
+    unsigned __int128 quotient, remainder, half;
+    if (k >= 0) {
+        if (k > 31)
+            return false;
+        unsigned __int128 num = m * formatPowerOfTen(k);  // below 2^24 * 2^103
+        if (e >= 0) {
+            if (e > 127 || (num >> (127 - e)) != 0)
+                return false;
+            quotient = num << e;
+            remainder = 0;
+            half = 1;
+        } else {
+            if (-e > 127)
+                return false;
+            quotient = num >> -e;
+            remainder = num & (((unsigned __int128)1 << -e) - 1);
+            half = (unsigned __int128)1 << (-e - 1);
+        }
+    } else {
+        if (-k > 38 || e < 0 || e > 104)
+            return false;
+        unsigned __int128 num = (unsigned __int128)m << e;
+        unsigned __int128 den = formatPowerOfTen(-k);
+        quotient = num / den;
+        // compare remainder / den with 1 / 2 without dividing
+        remainder = (num % den) * 2;
+        half = den;
+    }
+    if (quotient > UINT64_MAX)
+        return false;
+    *floorResult = (uint64_t)quotient;
+    *fraction = remainder < half ? -1 : (remainder == half ? 0 : 1);
+    return true;
+}
+
+int formatReal(char *dst, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t biasedExp = (bits >> 23) & 0xff;
+    uint32_t fraction = bits & 0x7fffff;
+    if (biasedExp == 0xff)  // inf and nan
+        return snprintf(dst, OUTPUT_BUFFER_MAX_NUMBER_LENGTH, "%g", (double)value);
+
+    char *pos = dst;
+    if (bits >> 31)
+        *pos++ = '-';
+    if (biasedExp == 0 && fraction == 0) {
+        *pos++ = '0';
+        return (int)(pos - dst);
+    }
+    // value is m * 2^e exactly
+    uint32_t m = biasedExp == 0 ? fraction : fraction | 0x800000;
+    int e = biasedExp == 0 ? -149 : (int)biasedExp - 150;
+
+    // find the decimal exponent that puts the 6 significant digits of "%g" in front of the decimal point
+    int exp10 = (int)floor(log10(fabs((double)value)));
+    uint64_t digits;
+    int dropped;
+    for (int attempt = 0; ; attempt++) {
+        if (attempt == 3 || !formatScaleExact(m, e, 5 - exp10, &digits, &dropped))
+            return snprintf(dst, OUTPUT_BUFFER_MAX_NUMBER_LENGTH, "%g", (double)value);
+        if (digits < 100000)
+            exp10--;
+        else if (digits >= 1000000)
+            exp10++;
+        else
+            break;
+    }
+    // round to nearest, ties to even, as printf does in the default rounding mode
+    if (dropped > 0 || (dropped == 0 && (digits & 1)))
+        digits++;
+    if (digits == 1000000) {
+        digits = 100000;
+        exp10++;
+    }
+
+    char text[6];
+    formatDigits(text, digits, 6);
+    int nSignificant = 6;  // "%g" drops trailing zeros of the fraction
+    while (nSignificant > 1 && text[nSignificant - 1] == '0')
+        nSignificant--;
+
+    if (exp10 < -4 || exp10 >= 6) {  // "%e" style
+        *pos++ = text[0];
+        if (nSignificant > 1) {
+            *pos++ = '.';
+            memcpy(pos, text + 1, nSignificant - 1);
+            pos += nSignificant - 1;
+        }
+        *pos++ = 'e';
+        *pos++ = exp10 < 0 ? '-' : '+';
+        int expMagnitude = exp10 < 0 ? -exp10 : exp10;
+        formatDigits(pos, expMagnitude, 2);  // floats never need a third exponent digit
+        pos += 2;
+    } else if (exp10 >= 0) {  // "%f" style with the decimal point inside the digits
+        memcpy(pos, text, exp10 + 1);
+        pos += exp10 + 1;
+        if (nSignificant > exp10 + 1) {
+            *pos++ = '.';
+            memcpy(pos, text + exp10 + 1, nSignificant - exp10 - 1);
+            pos += nSignificant - exp10 - 1;
+        }
+    } else {  // "%f" style with leading zeros
+        *pos++ = '0';
+        *pos++ = '.';
+        for (int i = -1; i > exp10; i--)
+            *pos++ = '0';
+        memcpy(pos, text, nSignificant);
+        pos += nSignificant;
+    }
+    return (int)(pos - dst);
+}
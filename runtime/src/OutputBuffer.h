@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * Byte buffers in front of a file descriptor, written out with large write() calls
+ * Everything the program sends to std_output goes through the process-wide stdout buffer, which is flushed when full,
+ * before a read from an interactive stdin and at exit
+ * Integers and reals are formatted by hand, producing the same text as printf's "%d" and "%g"
+ */
+
+#include <stdint.h>
+#include "Bool.h"
+
+#define OUTPUT_BUFFER_CAPACITY (1 << 16)
+#define OUTPUT_BUFFER_MAX_NUMBER_LENGTH 32  // upper bound on the text of one formatted integer or real
+
+typedef struct struct_gazprea_output_buffer {
+    int m_fd;
+    int64_t m_size;  // bytes waiting in m_data
+    int64_t m_capacity;
+    char *m_data;
+} OutputBuffer;
+
+void outputBufferInit(OutputBuffer *this, int fd, char *data, int64_t capacity);
+OutputBuffer *outputBufferStdout();
+void outputBufferFlush(OutputBuffer *this);
+void outputBufferFlushStdoutIfInteractive();  // keeps prompts visible before blocking on terminal input
+
+// make room for n more bytes, n must not be larger than the capacity
+void outputBufferReserve(OutputBuffer *this, int64_t n);
+void outputBufferWriteChar(OutputBuffer *this, char ch);
+void outputBufferWriteBytes(OutputBuffer *this, const char *bytes, int64_t n);
+
+// write the text to dst without a terminating zero and return its length, at most OUTPUT_BUFFER_MAX_NUMBER_LENGTH
+int formatInteger(char *dst, int32_t value);  // "%d"
+int formatReal(char *dst, float value);  // "%g"
@@ -1,18 +1,30 @@
+#include <pthread.h>
 #include "RuntimeErrors.h"
 #include "VariableStdio.h"
 
+// outlined comprehension bodies can fail on several threads at once, the first error is reported and ends the program
+// while the others wait here for the exit
+static pthread_mutex_t runtimeErrorMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void runtimeErrorBegin() {
+    pthread_mutex_lock(&runtimeErrorMutex);  // never unlocked
+}
+
 void errorAndExit(const char *errorMsg) {
+    runtimeErrorBegin();
     fprintf(stderr, "%s", errorMsg);
     exit(1);
 }
 
 void singleTypeError(Type *targetType, const char *errorMsg) {
+    runtimeErrorBegin();
     fprintf(stderr, "%s", errorMsg);
     typeDebugPrint(targetType);
     exit(1);
 }
 
 void doubleTypeError(Type *type1, Type *type2, const char *errorMsg) {
+    runtimeErrorBegin();
     fprintf(stderr, "%s", errorMsg);
     typeDebugPrint(type1);
     fprintf(stderr, " and ");
@@ -21,6 +33,7 @@ void doubleTypeError(Type *type1, Type *type2, const char *errorMsg) {
 }
 
 void unknownTypeVariableError() {
+    runtimeErrorBegin();
     fprintf(stderr, "Found a variable of unknown type!");
     exit(1);
 }
\ No newline at end of file
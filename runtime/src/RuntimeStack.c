@@ -21,30 +21,73 @@ void runtimeStackPush(RuntimeStack *stack, StackItem item) {
     stack->m_idx += 1;
 }
 
+ArenaChunk *arenaChunkMalloc() {
+    ArenaChunk *chunk = malloc(sizeof(ArenaChunk));
+    chunk->m_next = NULL;
+    chunk->m_used = 0;
+    return chunk;
+}
+// bump allocate an object of the given size, moving on to the next (possibly reused) chunk if the current one is full
+void *runtimeStackArenaAllocate(RuntimeStack *stack, int64_t size, ArenaChunk **chunk) {
+    size = (size + 7) & ~(int64_t)7;
+    ArenaChunk *current = stack->m_arena;
+    if (current->m_used + size > RUNTIME_STACK_ARENA_CHUNK_SIZE) {
+        if (current->m_next == NULL) {
+            current->m_next = arenaChunkMalloc();
+        }
+        current = current->m_next;
+        current->m_used = 0;
+        stack->m_arena = current;
+    }
+    void *result = current->m_data + current->m_used;
+    current->m_used += size;
+    *chunk = current;
+    return result;
+}
+void runtimeStackPushArenaItem(RuntimeStack *stack, StackItemType id, void *item, ArenaChunk *chunk) {
+    StackItem stackItem = {id, item, chunk};
+    runtimeStackPush(stack, stackItem);
+}
+
 /// interfaces
 RuntimeStack *runtimeStackMallocThenInit() {
     RuntimeStack *stack = malloc(sizeof(RuntimeStack));
     stack->m_size = 1;
     stack->m_stack = malloc(sizeof(StackItem));
     stack->m_idx = 0;
+    stack->m_arenaHead = arenaChunkMalloc();
+    stack->m_arena = stack->m_arenaHead;
     return stack;
 }
 void runtimeStackDestructThenFree(RuntimeStack *stack) {
     runtimeStackRestore(stack, 0);
+    ArenaChunk *chunk = stack->m_arenaHead;
+    while (chunk != NULL) {
+        ArenaChunk *next = chunk->m_next;
+        free(chunk);
+        chunk = next;
+    }
     free(stack->m_stack);
     free(stack);
 }
+// worker threads never exit before the program does, so their stacks are never freed
+RuntimeStack *runtimeStackGetThreadLocal() {
+    static _Thread_local RuntimeStack *threadLocalStack = NULL;
+    if (threadLocalStack == NULL)
+        threadLocalStack = runtimeStackMallocThenInit();
+    return threadLocalStack;
+}
 
 Variable *variableStackAllocate(RuntimeStack *stack) {
-    Variable *var = variableMalloc();
-    StackItem item = {STACK_ITEM_VARIABLE, var};
-    runtimeStackPush(stack, item);
+    ArenaChunk *chunk;
+    Variable *var = runtimeStackArenaAllocate(stack, sizeof(Variable), &chunk);
+    runtimeStackPushArenaItem(stack, STACK_ITEM_VARIABLE, var, chunk);
     return var;
 }
 Type *typeStackAllocate(RuntimeStack *stack) {
-    Type *type = typeMalloc();
-    StackItem item = {STACK_ITEM_TYPE, type};
-    runtimeStackPush(stack, item);
+    ArenaChunk *chunk;
+    Type *type = runtimeStackArenaAllocate(stack, sizeof(Type), &chunk);
+    runtimeStackPushArenaItem(stack, STACK_ITEM_TYPE, type, chunk);
     return type;
 }
 int64_t runtimeStackSave(RuntimeStack *stack) {
@@ -59,15 +102,21 @@ void runtimeStackRestore(RuntimeStack *stack, int64_t position) {
 #ifdef DEBUG_PRINT
                     fprintf(stderr, "daf#27(stack free)\n");
 #endif
-                    variableDestructThenFreeImpl(item->m_item);
+                    variableDestructor(item->m_item);
                 } break;
                 case STACK_ITEM_TYPE: {
-                    typeDestructThenFree(item->m_item);
+                    typeDestructor(item->m_item);
                 } break;
                 default:
                     errorAndExit("This should not happen!");
             }
         }
+        if (position < stack->m_idx) {
+            // release the whole region above the restored position at once
+            StackItem *first = &stack->m_stack[position];
+            stack->m_arena = first->m_chunk;
+            stack->m_arena->m_used = (char *)first->m_item - first->m_chunk->m_data;
+        }
         stack->m_idx = position;
     } else {
         errorAndExit("Attempt to restore stack to a invalid position!");
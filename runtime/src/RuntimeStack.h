@@ -5,20 +5,35 @@
 #include "Enums.h"
 
 
+// Variable and Type objects on the stack are bump allocated from arena chunks owned by the stack
+#define RUNTIME_STACK_ARENA_CHUNK_SIZE 4096
+
+typedef struct struct_runtime_stack_arena_chunk ArenaChunk;
+
+typedef struct struct_runtime_stack_arena_chunk {
+    ArenaChunk *m_next;  // chunks after the current one are kept around for reuse after a restore
+    int64_t m_used;
+    char m_data[RUNTIME_STACK_ARENA_CHUNK_SIZE];
+} ArenaChunk;
+
 typedef struct struct_runtime_stack_item {
     StackItemType m_typeid;
     void *m_item;
+    ArenaChunk *m_chunk;  // the chunk m_item lives in, the arena is rewound to m_item when the item is popped
 } StackItem;
 
 typedef struct struct_runtime_stack {
     int64_t m_idx;
     int64_t m_size;
     StackItem *m_stack;
+    ArenaChunk *m_arenaHead;
+    ArenaChunk *m_arena;  // the chunk currently bumped
 } RuntimeStack;
 
 /// INTERFACE
 RuntimeStack *runtimeStackMallocThenInit();
 void runtimeStackDestructThenFree(RuntimeStack *stack);
+RuntimeStack *runtimeStackGetThreadLocal();  // the stack of the calling thread, created on first use
 
 Variable *variableStackAllocate(RuntimeStack *stack);
 Type *typeStackAllocate(RuntimeStack *stack);
@@ -36,7 +51,13 @@ void runtimeStackRestore(RuntimeStack *stack, int64_t position);
 // runtimeStackDestructThenFree(stack)
 
 
+// thread pool task:
+// the stack pointer is a thread local global, a task that finds it null starts with
+// stack = runtimeStackGetThreadLocal();
+
+
 // every scoped variable or type (that is, not temporary variable)'s variableMalloc() or typeMalloc() is replaced with variableStackAllocate(stack)
+// the object is owned by the stack's arena, so it must only be freed by runtimeStackRestore() and never by variableDestructThenFree()
 
 
 // block statement
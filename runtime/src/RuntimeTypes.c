@@ -7,6 +7,7 @@
 #include "NDArray.h"
 #include "VariableStdio.h"
 #include "NDArrayVariable.h"
+#include "BitArray.h"
 
 ///------------------------------TYPE AND VARIABLE---------------------------------------------------------------
 
@@ -383,8 +384,9 @@ void *stridArrayMalloc(int64_t size) { return malloc(size * sizeof(int64_t)); }
 void stridArraySet(int64_t *arr, int64_t idx, int64_t val) { arr[idx] = val; }
 void stridArrayFree(int64_t *arr) { free(arr); }
 
-bool *acceptMatrixMalloc(int64_t nFilter, int64_t domainSize) { return (bool*)malloc(nFilter * domainSize * sizeof(bool)); }
-void acceptArraySet(bool *accept, int64_t domainSize, int64_t filterIdx, int64_t domainIdx, bool val) {
-    accept[domainSize * filterIdx + domainIdx] = val;
+uint64_t *acceptMatrixMalloc(int64_t nFilter, int64_t domainSize) { return bitArrayMalloc(nFilter * acceptMatrixRowLength(domainSize)); }
+int64_t acceptMatrixRowLength(int64_t domainSize) { return bitArrayNumWords(domainSize) * BIT_ARRAY_WORD_BITS; }
+void acceptArraySet(uint64_t *accept, int64_t domainSize, int64_t filterIdx, int64_t domainIdx, bool val) {
+    bitArraySet(accept, acceptMatrixRowLength(domainSize) * filterIdx + domainIdx, val);
 }
-void acceptMatrixFree(bool *accept) { free(accept); }
\ No newline at end of file
+void acceptMatrixFree(uint64_t *accept) { bitArrayFree(accept); }
\ No newline at end of file
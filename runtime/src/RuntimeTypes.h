@@ -98,7 +98,8 @@ void stridArraySet(int64_t *arr, int64_t idx, int64_t val);         /// INTERFAC
 void stridArrayFree(int64_t *arr);                                  /// INTERFACE
 
 // for filter
-// make an n * m matrix
-bool *acceptMatrixMalloc(int64_t nFilter, int64_t domainSize);                                              /// INTERFACE
-void acceptArraySet(bool *accept, int64_t domainSize, int64_t filterIdx, int64_t domainIdx, bool val);      /// INTERFACE
-void acceptMatrixFree(bool *accept);                                                                        /// INTERFACE
\ No newline at end of file
+// make an n * m bit matrix (see BitArray.h), each row is padded to whole words so rows never share a word
+uint64_t *acceptMatrixMalloc(int64_t nFilter, int64_t domainSize);                                          /// INTERFACE
+int64_t acceptMatrixRowLength(int64_t domainSize);  // the number of bits in a padded row
+void acceptArraySet(uint64_t *accept, int64_t domainSize, int64_t filterIdx, int64_t domainIdx, bool val);  /// INTERFACE
+void acceptMatrixFree(uint64_t *accept);                                                                    /// INTERFACE
\ No newline at end of file
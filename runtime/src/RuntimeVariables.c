@@ -79,11 +79,17 @@ void variableInitFromPCADP(Variable *this, Type *targetType, Variable *rhs, PCAD
         fprintf(stderr, "calling refToValue from PCADP\n");
 #endif
         variableInitFromNDArrayIndexRefToValue(rhsModified, rhs);
-        variableInitFromPCADP(this, targetType, rhsModified, config);
+        variableInitFromPCADPMove(this, targetType, rhsModified, config);
 #ifdef DEBUG_PRINT
         fprintf(stderr, "daf#14\n");
 #endif
-        variableDestructThenFreeImpl(rhsModified);
+        return;
+    }
+
+    // identical types skip the decision tree below, e.g. integer x = y; or a matrix passed to a parameter of its type
+    if (pcadpPlanFromTypes(targetType, rhs->m_type, config) == pcadp_plan_copy) {
+        variableInitFromMemcpy(this, rhs);
+        variableSetIsBlockScoped(this, config->m_resultIsBlockScoped);
         return;
     }
 
@@ -167,7 +173,7 @@ void variableInitFromPCADP(Variable *this, Type *targetType, Variable *rhs, PCAD
                 variableInitFromMixedArrayPromoteToSameType(this, rhs);
                 variableSetIsBlockScoped(this, config->m_resultIsBlockScoped);
             } else {
-                variableInitFromMemcpy(this, rhs);
+                variableInitFromMemcpy(this, rhs);  // the copy drops m_isLiteral, so the variable is a concrete array
                 variableSetIsBlockScoped(this, config->m_resultIsBlockScoped);
             }
         } else {
@@ -212,7 +218,7 @@ void variableInitFromPCADP(Variable *this, Type *targetType, Variable *rhs, PCAD
                 singleTypeError(targetType, "Attempt to convert interval to non basic type array:");
             } else {
                 arrayMallocFromCast(eid, ELEMENT_INTEGER, arrayLength, vec, &this->m_data);
-                free(vec);
+                freeListPoolFree(vec);
             }
         } else {
             singleTypeError(targetType, "Attempt to convert interval to:");
@@ -278,7 +284,8 @@ void variableInitFromPCADP(Variable *this, Type *targetType, Variable *rhs, PCAD
             int64_t *dims = CTI->m_dims;
             // TODO: check if this satisfies spec
             if (!config->m_allowArrToArrDifferentElementTypeConversion && rhsNDim != 0 &&
-                CTI->m_elementTypeID != rhsCTI->m_elementTypeID && rhsCTI->m_elementTypeID != ELEMENT_MIXED) {
+                CTI->m_elementTypeID != rhsCTI->m_elementTypeID && rhsCTI->m_elementTypeID != ELEMENT_MIXED &&
+                !rhsCTI->m_isLiteral) {
                 errorAndExit("No vector/matrix to vector/matrix different element type conversion allowed");
             } else if (nDim < rhsNDim) {
                 errorAndExit("Cannot convert to a lower dimension array!");
@@ -318,7 +325,7 @@ void variableInitFromPCADP(Variable *this, Type *targetType, Variable *rhs, PCAD
                                                 rhsDims[0], rhsDims[1], dims[0], dims[1], &this->m_data);
                 }
             }
-            free(convertedArray);
+            freeListPoolFree(convertedArray);
         }
         variableAttrInitHelper(this, -1, this->m_data, config->m_resultIsBlockScoped);
 #ifdef DEBUG_PRINT
@@ -328,6 +335,40 @@ void variableInitFromPCADP(Variable *this, Type *targetType, Variable *rhs, PCAD
     }
 }
 
+PCADPPlan pcadpPlanFromTypes(Type *targetType, Type *rhsType, PCADPConfig *config) {
+    if (rhsType->m_typeId != TYPEID_NDARRAY)
+        return pcadp_plan_convert;
+    ArrayType *rhsCTI = rhsType->m_compoundTypeInfo;
+    if (rhsCTI->m_isRef || rhsCTI->m_isLiteral || !elementIsBasicType(rhsCTI->m_elementTypeID))
+        return pcadp_plan_convert;
+    if (targetType->m_typeId == TYPEID_UNKNOWN)  // var a = <expr>;
+        return config->m_allowUnknownTargetType ? pcadp_plan_copy : pcadp_plan_convert;
+    if (targetType->m_typeId != TYPEID_NDARRAY)
+        return pcadp_plan_convert;
+    ArrayType *targetCTI = targetType->m_compoundTypeInfo;
+    if (targetCTI->m_isRef || targetCTI->m_isLiteral || targetCTI->m_elementTypeID != rhsCTI->m_elementTypeID ||
+        targetCTI->m_nDim != rhsCTI->m_nDim || targetCTI->m_isString != rhsCTI->m_isString)
+        return pcadp_plan_convert;
+
+    // an unknown size target dimension takes the size of rhs, same as the array -> array conversion
+    for (int8_t i = 0; i < rhsCTI->m_nDim; i++) {
+        int64_t dim = targetCTI->m_dims[i];
+        if (dim != rhsCTI->m_dims[i] && (dim >= 0 || !config->m_allowUnknownTargetArraySize))
+            return pcadp_plan_convert;
+    }
+    return pcadp_plan_copy;
+}
+
+void variableInitFromPCADPMove(Variable *this, Type *targetType, Variable *rhs, PCADPConfig *config) {
+    if (pcadpPlanFromTypes(targetType, rhs->m_type, config) == pcadp_plan_copy) {
+        variableInitFromMove(this, rhs);
+        variableSetIsBlockScoped(this, config->m_resultIsBlockScoped);
+    } else {
+        variableInitFromPCADP(this, targetType, rhs, config);
+        variableDestructThenFreeImpl(rhs);
+    }
+}
+
 Variable *variableMalloc() {
     Variable *var = malloc(sizeof(Variable));
 #ifdef DEBUG_PRINT
@@ -369,6 +410,23 @@ void variableInitFromMemcpy(Variable *this, Variable *other) {
 #endif
 }
 
+void variableInitFromMove(Variable *this, Variable *other) {
+    if (variableGetIndexRefTypeID(other) != NDARRAY_INDEX_REF_NOT_A_REF) {
+        // a reference does not own the elements it refers to
+        variableInitFromMemcpy(this, other);
+        variableDestructThenFreeImpl(other);
+        return;
+    }
+    // m_parent points into m_data or the type, never to the variable itself, so it stays valid
+    *this = *other;
+    this->m_fieldPos = -1;
+    this->m_isBlockScoped = false;
+    free(other);
+#ifdef DEBUG_PRINT
+    variableInitDebugPrint(this, "move");
+#endif
+}
+
 void variableInitFromIdentifier(Variable *this, Variable *other) {
     variableInitFromMemcpy(this, other);
 }
@@ -912,6 +970,9 @@ void variableInitFromAssign(Variable *this, Type *lhsType, Variable *rhs) {
 void variableInitFromDeclaration(Variable *this, Type *lhsType, Variable *rhs) {
     variableInitFromPCADP(this, lhsType, rhs, &pcadpDeclarationConfig);
 }
+void variableInitFromDeclarationMove(Variable *this, Type *lhsType, Variable *rhs) {
+    variableInitFromPCADPMove(this, lhsType, rhs, &pcadpDeclarationConfig);
+}
 void variableInitFromPromotion(Variable *this, Type *lhsType, Variable *rhs) {
     variableInitFromPCADP(this, lhsType, rhs, &pcadpPromotionConfig);
 }
@@ -1004,14 +1065,48 @@ void variableInitFromIntervalHeadTail(Variable *this, Variable *head, Variable *
 #endif
 }
 
+// number of elements in ivl by step
+int64_t intervalStepGetLength(int32_t *interval, int32_t step) {
+    if (step <= 0) {
+        errorAndExit("ivl by step has a step value of 0 or negative!");
+    }
+    return ((int64_t)interval[1] - interval[0]) / step + 1;
+}
+
+int64_t variableGetIntervalStepLength(Variable *ivl, Variable *step) {
+    if (!typeIsIntegerInterval(ivl->m_type))
+        singleTypeError(ivl->m_type, "Invalid type for variableGetIntervalStepLength!");
+    return intervalStepGetLength(ivl->m_data, variableGetIntervalStepValue(step));
+}
+
+int32_t variableGetIntervalStepValue(Variable *step) {
+    // promoted the same way the by operator promotes its step
+    Type *intType = typeMalloc();
+    typeInitFromArrayType(intType, false, ELEMENT_INTEGER, 0, NULL);
+    Variable *intVar = variableMalloc();
+    variableInitFromPromotion(intVar, intType, step);
+    int32_t k = *(int32_t *)intVar->m_data;
+    variableDestructThenFreeImpl(intVar);
+    typeDestructThenFree(intType);
+    return k;
+}
+
+void variableInitFromIntegerSequenceIndexing(Variable *this, int32_t head, int32_t step, int64_t length,
+                                             Variable *index) {
+    int32_t i = variableGetIntegerValue(index);
+    if (i < 1 || i > length) {
+        fprintf(stderr, "Index: %d Len: %ld\n", i - 1, length);
+        errorAndExit("Array access out of range!");
+    }
+    // the element is in the int32 range even when the offset is not, unsigned arithmetic wraps back onto it
+    variableInitFromIntegerScalar(this, (int32_t)((uint32_t)head + (uint32_t)(i - 1) * (uint32_t)step));
+}
+
 void variableInitFromIntervalStep(Variable *this, Variable *ivl, Variable *step) {
     int32_t *interval = ivl->m_data;
     int32_t k = *((int32_t *)step->m_data);
-    if (k <= 0) {
-        errorAndExit("ivl by step has a step value of 0 or negative!");
-    }
     int32_t value = 0;
-    int64_t dims[1] = {(interval[1] - interval[0]) / k + 1};
+    int64_t dims[1] = {intervalStepGetLength(interval, k)};
 
     variableInitFromNDArray(this, false, ELEMENT_INTEGER, 1, dims, &value, true);
     int32_t *vec = this->m_data;
@@ -1164,6 +1259,13 @@ void variableInitFromIntegerArrayElementAtIndex(Variable *this, Variable *arr, i
     variableSetIsBlockScoped(this, true);  //justin propose change
 }
 
+int32_t variableGetIntegerIntervalHead(Variable *this) {
+    if (this->m_type->m_typeId != TYPEID_INTERVAL)
+        singleTypeError(this->m_type, "Invalid type for variableGetIntegerIntervalHead!");
+    int32_t *interval = this->m_data;
+    return interval[0];
+}
+
 int32_t variableGetIntegerElementAtIndex(Variable *this, int64_t idx) {
     int64_t len = variableGetLength(this);
     if (idx < 0 || idx >= len) {
@@ -1236,6 +1338,69 @@ bool variableGetBooleanValue(Variable *this) {
     return result;
 }
 
+// returns the address of the scalar value if this is a concrete scalar of the given element type, NULL otherwise
+void *variableGetConcreteScalarPtr(Variable *this, ElementTypeID eid) {
+    if (this->m_type->m_typeId != TYPEID_NDARRAY)
+        return NULL;
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    if (CTI->m_nDim != 0 || CTI->m_isRef || CTI->m_elementTypeID != eid)
+        return NULL;
+    return this->m_data;
+}
+
+void *variableGetConcreteVectorData(Variable *this, ElementTypeID eid) {
+    if (this->m_type->m_typeId != TYPEID_NDARRAY)
+        return NULL;
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    if (CTI->m_nDim != 1 || CTI->m_isRef || CTI->m_elementTypeID != eid)
+        return NULL;
+    return this->m_data;
+}
+
+int32_t variableGetIntegerScalarValue(Variable *this) {
+    int32_t *value = variableGetConcreteScalarPtr(this, ELEMENT_INTEGER);
+    if (value != NULL)
+        return *value;
+    return variableGetIntegerValue(this);
+}
+
+float variableGetRealScalarValue(Variable *this) {
+    float *value = variableGetConcreteScalarPtr(this, ELEMENT_REAL);
+    if (value != NULL)
+        return *value;
+
+    Type *realTy = typeMalloc();
+    typeInitFromArrayType(realTy, false, ELEMENT_REAL, 0, NULL);
+    Variable *realVar = variableMalloc();
+    variableInitFromPromotion(realVar, realTy, this);
+    float result = *(float *)realVar->m_data;
+    variableDestructThenFreeImpl(realVar);
+    typeDestructThenFree(realTy);
+    return result;
+}
+
+bool variableGetBooleanScalarValue(Variable *this) {
+    bool *value = variableGetConcreteScalarPtr(this, ELEMENT_BOOLEAN);
+    if (value != NULL)
+        return *value;
+    return variableGetBooleanValue(this);
+}
+
+int8_t variableGetCharacterScalarValue(Variable *this) {
+    int8_t *value = variableGetConcreteScalarPtr(this, ELEMENT_CHARACTER);
+    if (value != NULL)
+        return *value;
+
+    Type *charTy = typeMalloc();
+    typeInitFromArrayType(charTy, false, ELEMENT_CHARACTER, 0, NULL);
+    Variable *charVar = variableMalloc();
+    variableInitFromPromotion(charVar, charTy, this);
+    int8_t result = *(int8_t *)charVar->m_data;
+    variableDestructThenFreeImpl(charVar);
+    typeDestructThenFree(charTy);
+    return result;
+}
+
 int64_t variableGetNumFieldInTuple(Variable *this) {
     if (this->m_type->m_typeId != TYPEID_TUPLE) {
         singleTypeError(this->m_type, "The given type is not a tuple: ");
@@ -1289,18 +1454,35 @@ void variableAssignment(Variable *this, Variable *rhs) {
 
     Variable *result = variableMalloc();
     variableInitFromAssign(result, this->m_type, rhs);
+    variableAssignmentFromConverted(this, result);
+}
 
+void variableAssignmentMove(Variable *this, Variable *rhs) {
+    Variable *result = variableMalloc();
+    variableInitFromPCADPMove(result, this->m_type, rhs, &pcadpAssignmentConfig);
+    variableAssignmentFromConverted(this, result);
+}
+
+void variableAssignmentFromConverted(Variable *this, Variable *result) {
     NDArrayIndexRefTypeID refTypeID = variableGetIndexRefTypeID(this);
     if (refTypeID == NDARRAY_INDEX_REF_NOT_A_REF) {
+        // this takes over the buffers of result
         variableDestructor(this);
-        variableInitFromMemcpy(this, result);
+        variableInitFromMove(this, result);
         variableSetIsBlockScoped(this, true);
-    } else {  // index assignment
-        if (!typeIsArraySameTypeSameSize(this->m_type, result->m_type))
-            singleTypeError(result->m_type, "Incompatible rhs type for index assignment: ");
-        int64_t len = variableGetLength(result);
-        ArrayType *CTI = this->m_type->m_compoundTypeInfo;
-        ElementTypeID eid = CTI->m_elementTypeID;
+        return;
+    }
+
+    // index assignment
+    if (!typeIsArraySameTypeSameSize(this->m_type, result->m_type))
+        singleTypeError(result->m_type, "Incompatible rhs type for index assignment: ");
+    int64_t len = variableGetLength(result);
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    ElementTypeID eid = CTI->m_elementTypeID;
+    variableNDArrayPrepareWrite(this);
+    if (variableNDArrayIsStridedView(this) && variableGetIndexRefTypeID(result) == NDARRAY_INDEX_REF_NOT_A_REF) {
+        ndarrayStridedViewScatter(this, result->m_data);
+    } else {
         for (int64_t i = 0; i < len; i++) {
             void *target = variableNDArrayGet(this, i);
             void *src = variableNDArrayGet(result, i);
@@ -42,8 +42,18 @@ extern PCADPConfig pcadpDeclarationConfig;
 extern PCADPConfig pcadpPromotionConfig;
 extern PCADPConfig pcadpDomainExpressionConfig;
 
+typedef enum enum_pcadp_plan {
+    pcadp_plan_convert,  // run the full conversion decision tree
+    pcadp_plan_copy,  // rhs already has the target type, the result is a copy (copy-on-write for arrays) of rhs
+} PCADPPlan;
+
+PCADPPlan pcadpPlanFromTypes(Type *targetType, Type *rhsType, PCADPConfig *config);
+// same as variableInitFromPCADP but rhs is a temporary that is consumed, its buffers are taken over when possible
+void variableInitFromPCADPMove(Variable *this, Type *targetType, Variable *rhs, PCADPConfig *config);
+
 void variableInitFromPCADP(Variable *this, Type *targetType, Variable *rhs, PCADPConfig *config);
 void variableInitFromMemcpy(Variable *this, Variable *other);
+void variableInitFromMove(Variable *this, Variable *other);  // other is freed and must not be used afterwards
 void variableInitFromIdentifier(Variable *this, Variable *other);                                 /// INTERFACE
 void variableInitFromNull(Variable *this, Type *type);
 void variableInitFromIdentity(Variable *this, Type *type);
@@ -53,6 +63,7 @@ void variableInitFromBinaryOp(Variable *this, Variable *op1, Variable *op2, BinO
 void variableInitFromParameter(Variable *this, Type *lhsType, Variable *rhs);                     /// INTERFACE
 void variableInitFromCast(Variable *this, Type *lhsType, Variable *rhs);                          /// INTERFACE
 void variableInitFromDeclaration(Variable *this, Type *lhsType, Variable *rhs);                   /// INTERFACE
+void variableInitFromDeclarationMove(Variable *this, Type *lhsType, Variable *rhs);               /// INTERFACE rhs is consumed
 void variableInitFromAssign(Variable *this, Type *lhsType, Variable *rhs);
 void variableInitFromPromotion(Variable *this, Type *lhsType, Variable *rhs);                     /// INTERFACE
 void variableInitFromDomainExpression(Variable *this, Variable *rhs);                             /// INTERFACE
@@ -64,6 +75,13 @@ void variableInitFromScalarToConcreteArray(Variable *this, Variable *scalar, int
 void variableInitFromMixedArrayPromoteToSameType(Variable *this, Variable *mixed);
 void variableInitFromIntervalHeadTail(Variable *this, Variable *head, Variable *tail);
 void variableInitFromIntervalStep(Variable *this, Variable *ivl, Variable *step);  // the new variable is a vector
+int64_t intervalStepGetLength(int32_t *interval, int32_t step);
+// ivl by step without materializing it, element i is head + i * step
+int64_t variableGetIntervalStepLength(Variable *ivl, Variable *step);                             /// INTERFACE
+int32_t variableGetIntervalStepValue(Variable *step);                                             /// INTERFACE
+// element index (1 based) of the sequence head, head + step, ... with length elements, the sequence is never stored
+void variableInitFromIntegerSequenceIndexing(Variable *this, int32_t head, int32_t step, int64_t length,
+                                             Variable *index);                                    /// INTERFACE
 void variableInitFromNDArray(Variable *this, bool isString, ElementTypeID eid, int8_t nDim, int64_t *dims,
                              void *value, bool valueIsScalar);
 void variableDestructor(Variable *this);                                                          /// INTERFACE
@@ -75,6 +93,7 @@ bool variableIsIntegerInterval(Variable *this);
 bool variableIsIntegerArray(Variable *this);
 bool variableIsDomainExprCompatible(Variable *this);
 int64_t variableGetLength(Variable *this);
+int32_t variableGetIntegerIntervalHead(Variable *this);                                           /// INTERFACE
 void variableInitFromArrayElementAtIndex(Variable *this, Variable *arr, int64_t idx);
 void variableInitFromIntegerArrayElementAtIndex(Variable *this, Variable *arr, int64_t idx);
 int32_t variableGetIntegerElementAtIndex(Variable *this, int64_t idx);  // works for both vectors and integer intervals
@@ -87,9 +106,19 @@ void variableAttrInitHelper(Variable *this, int64_t fieldPos, void *m_parent, bo
 // promote to integer scalar and return the value as int32_t
 int32_t variableGetIntegerValue(Variable *this);                                                  /// INTERFACE
 bool variableGetBooleanValue(Variable *this);                                                     /// INTERFACE
+// direct access to scalars with a compile time known type, falls back to promotion if the variable is not such scalar
+void *variableGetConcreteScalarPtr(Variable *this, ElementTypeID eid);
+// m_data of a non-reference vector with the element type, NULL for any other variable
+void *variableGetConcreteVectorData(Variable *this, ElementTypeID eid);                           /// INTERFACE
+int32_t variableGetIntegerScalarValue(Variable *this);                                            /// INTERFACE
+float variableGetRealScalarValue(Variable *this);                                                 /// INTERFACE
+bool variableGetBooleanScalarValue(Variable *this);                                               /// INTERFACE
+int8_t variableGetCharacterScalarValue(Variable *this);                                           /// INTERFACE
 Variable *variableGetTupleField(Variable *tuple, int64_t pos);                                    /// INTERFACE
 Variable *variableGetTupleFieldFromID(Variable *tuple, int64_t id);                               /// INTERFACE
 int64_t variableGetNumFieldInTuple(Variable *this);                                               /// INTERFACE
 bool variableAliasWith(Variable *this, Variable *other);                                          /// INTERFACE return ture if the two variable alias
 void variableAssignment(Variable *this, Variable *rhs);                                           /// INTERFACE
+void variableAssignmentMove(Variable *this, Variable *rhs);                                       /// INTERFACE rhs is consumed
+void variableAssignmentFromConverted(Variable *this, Variable *result);  // result already has the type of this, it is consumed
 void variableReplace(Variable *this, Variable *rhs);                                              /// INTERFACE
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include <pthread.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "Bool.h"
+#include "FreeList.h"
+#include "ThreadPool.h"
+
+#define THREAD_POOL_MAX_THREADS 256
+
+// the part of a parallel for owned by one thread; the owner takes chunks from the front and thieves split off the back
+typedef struct struct_gazprea_work_range {
+    pthread_mutex_t m_mutex;
+    int64_t m_begin;
+    int64_t m_end;
+    char m_padding[64];  // keep neighbouring ranges on different cache lines
+} WorkRange;
+
+typedef struct struct_gazprea_parallel_for_job {
+    ThreadPoolTask m_task;
+    void *m_arg;
+    int64_t m_grain;
+    WorkRange *m_ranges;  // one per thread, indexed by the thread id
+} ParallelForJob;
+
+typedef struct struct_gazprea_thread_pool {
+    pthread_mutex_t m_mutex;
+    pthread_cond_t m_jobReady;
+    pthread_cond_t m_jobDone;
+    pthread_mutex_t m_issueMutex;  // one parallel for at a time
+    ParallelForJob *m_job;
+    int64_t m_generation;  // bumped for every job so sleeping workers can tell a new job from a spurious wakeup
+    int64_t m_numBusyWorkers;
+    int64_t m_numThreads;
+    WorkRange m_ranges[THREAD_POOL_MAX_THREADS];
+} ThreadPool;
+
+static ThreadPool threadPool = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_MUTEX_INITIALIZER,
+    NULL, 0, 0, 0
+};
+static pthread_once_t threadPoolOnce = PTHREAD_ONCE_INIT;
+static _Thread_local int threadPoolInTask = 0;
+static _Thread_local int64_t threadPoolThreadID = 0;  // 0 for the thread issuing parallel fors, 1.. for the workers
+
+// take the next chunk of the calling thread's own range, returns false if it is empty
+bool workRangePopFront(WorkRange *range, int64_t grain, int64_t *begin, int64_t *end) {
+    pthread_mutex_lock(&range->m_mutex);
+    bool found = range->m_begin < range->m_end;
+    if (found) {
+        *begin = range->m_begin;
+        *end = range->m_end - range->m_begin > grain ? range->m_begin + grain : range->m_end;
+        range->m_begin = *end;
+    }
+    pthread_mutex_unlock(&range->m_mutex);
+    return found;
+}
+
+// split off the back half of a victim's range, or all of it if it is a single chunk; returns false if it is empty
+bool workRangeStealBack(WorkRange *range, int64_t grain, int64_t *begin, int64_t *end) {
+    pthread_mutex_lock(&range->m_mutex);
+    int64_t remaining = range->m_end - range->m_begin;
+    bool found = remaining > 0;
+    if (found) {
+        *end = range->m_end;
+        *begin = remaining > grain ? range->m_end - remaining / 2 : range->m_begin;
+        range->m_end = *begin;
+    }
+    pthread_mutex_unlock(&range->m_mutex);
+    return found;
+}
+
+void workRangeSet(WorkRange *range, int64_t begin, int64_t end) {
+    pthread_mutex_lock(&range->m_mutex);
+    range->m_begin = begin;
+    range->m_end = end;
+    pthread_mutex_unlock(&range->m_mutex);
+}
+
+// run the thread's own range, then keep stealing until no thread has indices left that nobody has claimed
+void parallelForJobRun(ParallelForJob *job) {
+    threadPoolInTask = 1;
+    int64_t self = threadPoolThreadID;
+    int64_t numThreads = threadPool.m_numThreads;
+    WorkRange *own = &job->m_ranges[self];
+    while (1) {
+        int64_t begin, end;
+        while (workRangePopFront(own, job->m_grain, &begin, &end))
+            job->m_task(job->m_arg, begin, end);
+
+        bool stole = false;
+        for (int64_t i = 1; i < numThreads && !stole; i++) {
+            stole = workRangeStealBack(&job->m_ranges[(self + i) % numThreads], job->m_grain, &begin, &end);
+        }
+        if (!stole)
+            break;
+        workRangeSet(own, begin, end);
+    }
+    threadPoolInTask = 0;
+}
+
+void *threadPoolWorkerMain(void *id) {
+    threadPoolThreadID = (int64_t)(intptr_t)id;
+    freeListPoolDisableOnThisThread();
+    int64_t seenGeneration = 0;
+    pthread_mutex_lock(&threadPool.m_mutex);
+    while (1) {
+        while (threadPool.m_generation == seenGeneration)
+            pthread_cond_wait(&threadPool.m_jobReady, &threadPool.m_mutex);
+        seenGeneration = threadPool.m_generation;
+        ParallelForJob *job = threadPool.m_job;
+        pthread_mutex_unlock(&threadPool.m_mutex);
+
+        parallelForJobRun(job);
+
+        pthread_mutex_lock(&threadPool.m_mutex);
+        threadPool.m_numBusyWorkers--;
+        if (threadPool.m_numBusyWorkers == 0)
+            pthread_cond_signal(&threadPool.m_jobDone);
+    }
+    return NULL;
+}
+
+// GAZ_THREADS if it is a positive number, otherwise the number of online processors
+int64_t threadPoolRequestedNumThreads() {
+    int64_t numThreads = 0;
+    char *knob = getenv("GAZ_THREADS");
+    if (knob != NULL) {
+        char *end;
+        numThreads = strtol(knob, &end, 10);
+        if (end == knob || *end != '\0')
+            numThreads = 0;
+    }
+    if (numThreads < 1)
+        numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+    if (numThreads < 1)
+        numThreads = 1;
+    if (numThreads > THREAD_POOL_MAX_THREADS)
+        numThreads = THREAD_POOL_MAX_THREADS;
+    return numThreads;
+}
+
+void threadPoolInit() {
+    int64_t numThreads = threadPoolRequestedNumThreads();
+    for (int64_t i = 0; i < numThreads; i++)
+        pthread_mutex_init(&threadPool.m_ranges[i].m_mutex, NULL);
+    threadPool.m_numThreads = 1;
+    for (int64_t i = 1; i < numThreads; i++) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, threadPoolWorkerMain, (void *)(intptr_t)i) != 0)
+            break;
+        pthread_detach(worker);
+        threadPool.m_numThreads++;
+    }
+}
+
+int64_t threadPoolGetNumThreads() {
+    pthread_once(&threadPoolOnce, threadPoolInit);
+    return threadPool.m_numThreads;
+}
+
+void threadPoolParallelFor(int64_t begin, int64_t end, int64_t grain, ThreadPoolTask task, void *arg) {
+    if (begin >= end)
+        return;
+    if (grain < 1)
+        grain = 1;
+    if (threadPoolInTask || end - begin <= grain || threadPoolGetNumThreads() == 1) {
+        task(arg, begin, end);
+        return;
+    }
+
+    pthread_mutex_lock(&threadPool.m_issueMutex);
+    ParallelForJob job;
+    job.m_task = task;
+    job.m_arg = arg;
+    job.m_grain = grain;
+    job.m_ranges = threadPool.m_ranges;
+    // every thread starts with an equal contiguous share, uneven chunks are balanced by stealing
+    int64_t numThreads = threadPool.m_numThreads;
+    int64_t length = end - begin;
+    for (int64_t i = 0; i < numThreads; i++)
+        workRangeSet(&job.m_ranges[i], begin + length * i / numThreads, begin + length * (i + 1) / numThreads);
+
+    pthread_mutex_lock(&threadPool.m_mutex);
+    threadPool.m_job = &job;
+    threadPool.m_numBusyWorkers = numThreads - 1;
+    threadPool.m_generation++;
+    pthread_cond_broadcast(&threadPool.m_jobReady);
+    pthread_mutex_unlock(&threadPool.m_mutex);
+
+    parallelForJobRun(&job);  // the issuing thread runs its share too
+
+    pthread_mutex_lock(&threadPool.m_mutex);
+    while (threadPool.m_numBusyWorkers > 0)
+        pthread_cond_wait(&threadPool.m_jobDone, &threadPool.m_mutex);
+    threadPool.m_job = NULL;
+    pthread_mutex_unlock(&threadPool.m_mutex);
+    pthread_mutex_unlock(&threadPool.m_issueMutex);
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+/**
+ * A fixed pool of worker threads for data parallel runtime kernels
+ * The workers are started the first time a parallel for is issued and live until the program exits
+ * Set the environment variable GAZ_THREADS to the number of threads to use, the default is one per online processor
+ * Each thread starts a parallel for with an equal share of the index range and steals half of another thread's
+ * remaining share once its own runs out
+ * A parallel for issued from inside a task runs serially on the calling thread
+ */
+
+#include <stdint.h>
+
+// processes the index range [begin, end) of a parallel for
+typedef void (*ThreadPoolTask)(void *arg, int64_t begin, int64_t end);
+
+int64_t threadPoolGetNumThreads();  // including the thread that issues the parallel for
+// split [begin, end) into chunks of grain indices and run task on them in parallel, returns when all chunks are done
+void threadPoolParallelFor(int64_t begin, int64_t end, int64_t grain, ThreadPoolTask task, void *arg);
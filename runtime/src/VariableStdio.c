@@ -1,4 +1,7 @@
+#include <errno.h>
 #include <math.h>
+#include <string.h>
+#include <unistd.h>
 #include "VariableStdio.h"
 #include "RuntimeVariables.h"
 #include "RuntimeErrors.h"
@@ -7,6 +10,7 @@
 #include "ctype.h"
 #include "limits.h"
 #include "NDArrayVariable.h"
+#include "OutputBuffer.h"
 
 void typeDebugPrint(Type *this) {
     FILE *fd = stderr;
@@ -85,40 +89,52 @@ void variablePrintToStream(Variable *this, Variable *stream) {
     variablePrintToStdout(this);
 }
 
-void elementPrintToFile(FILE *fd, ElementTypeID id, void *value) {
+// at most OUTPUT_BUFFER_MAX_NUMBER_LENGTH bytes per element
+void elementPrintToBuffer(OutputBuffer *buffer, ElementTypeID id, void *value) {
+    outputBufferReserve(buffer, OUTPUT_BUFFER_MAX_NUMBER_LENGTH);
+    char *dst = buffer->m_data + buffer->m_size;
     switch (id) {
         case ELEMENT_INTEGER:
-            fprintf(fd, "%d", *(int32_t *)value);
+            buffer->m_size += formatInteger(dst, *(int32_t *)value);
             break;
         case ELEMENT_REAL:
-            fprintf(fd, "%g", *(float *)value);
+            buffer->m_size += formatReal(dst, *(float *)value);
             break;
         case ELEMENT_BOOLEAN:
-            if (*(bool *)value) {
-                fprintf(fd, "T");
-            } else {
-                fprintf(fd, "F");
-            }
+            *dst = *(bool *)value ? 'T' : 'F';
+            buffer->m_size += 1;
             break;
         case ELEMENT_CHARACTER:
-            fprintf(fd, "%c", *(int8_t *)value);
+            *dst = (char)*(int8_t *)value;
+            buffer->m_size += 1;
             break;
         case ELEMENT_NULL:
-            fprintf(fd, "%c", 0x00);
+            *dst = 0x00;
+            buffer->m_size += 1;
             break;
         case ELEMENT_IDENTITY:
-            fprintf(fd, "%c", 0x01);
+            *dst = 0x01;
+            buffer->m_size += 1;
             break;
         default:
             errorAndExit("Unexpected element id when printing to stdout!"); break;
     }
 }
 
-void variablePrintToFile(FILE *fd, Variable *this) {
+// elements are contiguous, eid is not a mixed element
+void elementArrayPrintToBuffer(OutputBuffer *buffer, ElementTypeID eid, char *data, int64_t elementSize, int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+        if (i != 0)
+            outputBufferWriteChar(buffer, ' ');
+        elementPrintToBuffer(buffer, eid, data + i * elementSize);
+    }
+}
+
+void variablePrintToBuffer(OutputBuffer *buffer, Variable *this) {
     // only arrays and string can be printed
     Variable *temp = variableConvertLiteralAndRefToConcreteArray(this);
     if (temp) {
-        variablePrintToFile(fd, temp);
+        variablePrintToBuffer(buffer, temp);
 #ifdef DEBUG_PRINT
         fprintf(stderr, "daf#25\n");
 #endif
@@ -127,13 +143,13 @@ void variablePrintToFile(FILE *fd, Variable *this) {
     } else if (typeIsIntegerInterval(this->m_type)) {
         Variable *vec = variableMalloc();
         variableInitFromPCADPToIntegerVector(vec, this, &pcadpCastConfig);
-        variablePrintToFile(fd, vec);
+        variablePrintToBuffer(buffer, vec);
         variableDestructThenFreeImpl(vec);
         return;
     }
 
     if (typeIsEmptyArray(this->m_type)) {
-        fprintf(fd, "[]");
+        outputBufferWriteBytes(buffer, "[]", 2);
         return;
     }
 
@@ -141,44 +157,31 @@ void variablePrintToFile(FILE *fd, Variable *this) {
     if (type->m_typeId == TYPEID_NDARRAY) {
         ArrayType *CTI = type->m_compoundTypeInfo;
 
+        // not a reference or literal past this point, so the elements are contiguous in m_data
         if (CTI->m_isString) {
-            int64_t size = arrayTypeGetTotalLength(CTI);
-            for (int64_t i = 0; i < size; i++) {
-                int8_t *ch = variableNDArrayGet(this, i);
-                fprintf(fd, "%c", *ch);
-            }
+            outputBufferWriteBytes(buffer, this->m_data, arrayTypeGetTotalLength(CTI));
         } else {
             ElementTypeID eid = CTI->m_elementTypeID;
             if (CTI->m_nDim == 0)  // scalar
-                elementPrintToFile(fd, eid, variableNDArrayGet(this, 0));
+                elementPrintToBuffer(buffer, eid, variableNDArrayGet(this, 0));
             else {
                 int64_t elementSize = arrayTypeElementSize(CTI);
                 int64_t *dims = CTI->m_dims;
+                char *data = this->m_data;
                 if (CTI->m_nDim == 1) {  // vector
-                    fprintf(fd, "[");
-                    for (int64_t i = 0; i < dims[0]; i++) {
-                        elementPrintToFile(fd, eid, variableNDArrayGet(this, i));
-                        if (i != dims[0] - 1) {
-                            fprintf(fd, " ");
-                        }
-                    }
-                    fprintf(fd, "]");
+                    outputBufferWriteChar(buffer, '[');
+                    elementArrayPrintToBuffer(buffer, eid, data, elementSize, dims[0]);
+                    outputBufferWriteChar(buffer, ']');
                 } else {  // matrix
-                    fprintf(fd, "[");
+                    outputBufferWriteChar(buffer, '[');
                     for (int64_t i = 0; i < dims[0]; i++) {
-                        fprintf(fd, "[");
-                        for (int64_t j = 0; j < dims[1]; j++) {
-                            elementPrintToFile(fd, eid, variableNDArrayGet(this, i * dims[1] + j));
-                            if (j != dims[1] - 1) {
-                                fprintf(fd, " ");
-                            }
-                        }
-                        fprintf(fd, "]");
-                        if (i != dims[0] - 1) {
-                            fprintf(fd, " ");
-                        }
+                        if (i != 0)
+                            outputBufferWriteChar(buffer, ' ');
+                        outputBufferWriteChar(buffer, '[');
+                        elementArrayPrintToBuffer(buffer, eid, data + i * dims[1] * elementSize, elementSize, dims[1]);
+                        outputBufferWriteChar(buffer, ']');
                     }
-                    fprintf(fd, "]");
+                    outputBufferWriteChar(buffer, ']');
                 }
             }
         }
@@ -187,6 +190,20 @@ void variablePrintToFile(FILE *fd, Variable *this) {
     }
 }
 
+void variablePrintToFile(FILE *fd, Variable *this) {
+    if (fd == stdout) {
+        variablePrintToBuffer(outputBufferStdout(), this);
+        return;
+    }
+    // other files (debug prints to stderr) are written through right away
+    char data[1024];
+    OutputBuffer buffer;
+    outputBufferInit(&buffer, fileno(fd), data, sizeof(data));
+    fflush(fd);
+    variablePrintToBuffer(&buffer, this);
+    outputBufferFlush(&buffer);
+}
+
 void variablePrintToStdout(Variable *this) {
 #ifdef DEBUG_PRINT
     fprintf(stderr, "(var print %p)\n", this);
@@ -257,12 +274,64 @@ void variableInitDebugPrint(Variable *this, char *msg) {
 
 ///------------------------------STREAM_STD_INPUT---------------------------------------------------------------
 
+/**
+ * Reads one element per element of a vector or matrix in row-major order, straight into the packed buffer of a new
+ * array that is then moved into this; the stream state is the one of the last read
+ * After a read fails every later read would fail again at the same rewound position, so the rest of the elements
+ * keep the null value a failed read gives
+ */
+void variableReadArrayFromStdin(Variable *this) {
+    ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    ElementTypeID eid = CTI->m_elementTypeID;
+    Variable *rhs = variableMalloc();
+    variableInitFromNDArray(rhs, CTI->m_isString, eid, CTI->m_nDim, CTI->m_dims, NULL, false);
+    int64_t size = arrayTypeGetTotalLength(rhs->m_type->m_compoundTypeInfo);
+    switch (eid) {
+        case ELEMENT_INTEGER: {
+            int32_t *data = rhs->m_data;
+            for (int64_t i = 0; i < size; i++) {
+                data[i] = readIntegerFromStdin();
+                if (global_stream_state != 0)
+                    break;
+            }
+        } break;
+        case ELEMENT_REAL: {
+            float *data = rhs->m_data;
+            for (int64_t i = 0; i < size; i++) {
+                data[i] = readRealFromStdin();
+                if (global_stream_state != 0)
+                    break;
+            }
+        } break;
+        case ELEMENT_BOOLEAN: {
+            bool *data = rhs->m_data;
+            for (int64_t i = 0; i < size; i++) {
+                data[i] = readBooleanFromStdin();
+                if (global_stream_state != 0)
+                    break;
+            }
+        } break;
+        case ELEMENT_CHARACTER: {  // never fails
+            int8_t *data = rhs->m_data;
+            for (int64_t i = 0; i < size; i++)
+                data[i] = readCharacterFromStdin();
+        } break;
+        default:
+            singleTypeError(this->m_type, "Attempt to read from stdin into a variable of type:"); break;
+    }
+    variableAssignmentMove(this, rhs);
+}
+
 void variableReadFromStdin(Variable *this) {
     TypeID tid = this->m_type->m_typeId;
     if (tid != TYPEID_NDARRAY) {
         singleTypeError(this->m_type, "Attempt to read from stdin into a variable of type:");
     }
     ArrayType *CTI = this->m_type->m_compoundTypeInfo;
+    if (CTI->m_nDim > 0) {
+        variableReadArrayFromStdin(this);
+        return;
+    }
     Variable *rhs = variableMalloc();
     switch (CTI->m_elementTypeID) {
         case ELEMENT_INTEGER:
@@ -286,85 +355,105 @@ void variableReadFromStdin(Variable *this) {
 ///------------------------------HELPERS---------------------------------------------------------------
 
 int32_t global_stream_state = 0;  // 0, 1, 2 = success, error, eof
-#define BUFFER_SIZE 1024
+#define INPUT_BUFFER_BLOCK_SIZE (1 << 20)
 
 /**
- * only a section of the buffer will be used at any given time
- * the section is every character starting from cur_pos up to but not include the valid_until pos
+ * stdin is read in large blocks into input_buffer, which only keeps the characters from last_successful_read on
+ * the valid section is every character starting from last_successful_read up to but not include the valid_until pos
+ * the buffer is compacted (and grown if a single read spans all of it) when a block does not fit behind valid_until
  */
-char circular_buffer[BUFFER_SIZE];  // only a section of the buffer will be used at any given time
-char token_buffer[BUFFER_SIZE];  // holds the result of readNextToken()
-int result_token_length = 0;
-int last_successful_read = 0;  // the position right after the last successful read
-int cur_pos = 0;  // the next character will start reading from here
-int valid_until = 0;
+char *input_buffer = NULL;
+int64_t input_buffer_capacity = 0;
+bool input_eof = false;  // read() reported the end of stdin, which is sticky like the eof flag of a FILE
+char *token_buffer = NULL;  // points into input_buffer at the result of readNextToken()
+int64_t result_token_length = 0;
+int64_t last_successful_read = 0;  // the position right after the last successful read
+int64_t cur_pos = 0;  // the next character will start reading from here
+int64_t valid_until = 0;
 
 
 int32_t getStdinState() { return global_stream_state; }
-int getNextPos(int pos) { return (pos + 1) % BUFFER_SIZE; }
-int getPrevPos(int pos) { return (pos + BUFFER_SIZE - 1) % BUFFER_SIZE; }
 void rewindInputBuffer() { cur_pos = last_successful_read; }
 // on a successful read, we want to register the new rewind point
-void updateRewindPoint(int newRewindPoint) { last_successful_read = newRewindPoint; }
+void updateRewindPoint(int64_t newRewindPoint) { last_successful_read = newRewindPoint; }
+
+// read the next block of stdin behind valid_until, return false on eof
+bool fillInputBuffer() {
+    if (input_eof)
+        return false;
+    if (valid_until == input_buffer_capacity) {
+        // characters before the rewind point will never be read again
+        int64_t shift = last_successful_read;
+        if (shift > 0) {
+            memmove(input_buffer, input_buffer + shift, valid_until - shift);
+            last_successful_read -= shift;
+            cur_pos -= shift;
+            valid_until -= shift;
+        }
+        if (valid_until == input_buffer_capacity) {
+            input_buffer_capacity = input_buffer_capacity == 0 ? INPUT_BUFFER_BLOCK_SIZE : input_buffer_capacity * 2;
+            input_buffer = realloc(input_buffer, input_buffer_capacity);
+            if (input_buffer == NULL)
+                errorAndExit("Error: Out of memory when reading from stdin!");
+        }
+    }
+    outputBufferFlushStdoutIfInteractive();
+    ssize_t n;
+    do {
+        n = read(STDIN_FILENO, input_buffer + valid_until, input_buffer_capacity - valid_until);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) {
+        input_eof = true;
+        return false;
+    }
+    valid_until += n;
+    return true;
+}
 
 // https://en.cppreference.com/w/c/io/feof
 // return EOF on unsuccessful read, otherwise the result can be converted to char
 int readNextChar() {
-    if (cur_pos == valid_until) {
-        int ch = fgetc(stdin);
-        if (ch != EOF) {
-            circular_buffer[cur_pos] = (char)ch;
-            cur_pos = getNextPos(cur_pos);
-            valid_until = cur_pos;
-            if (cur_pos == last_successful_read) {
-                // emit an error
-                errorAndExit("Error: Attempt to read an input longer than the input buffer length 1024!");
-            }
-        }
-        return ch;
-    } else {
-        // just read from the saved buffer
-        char ch = circular_buffer[cur_pos];
-        cur_pos = getNextPos(cur_pos);
-        return ch;
-    }
+    if (cur_pos == valid_until && !fillInputBuffer())
+        return EOF;
+    return (unsigned char)input_buffer[cur_pos++];
 }
 
-// will malloc for the token and return one character after the token's last character
-// e.g. this will return a space on success read, 2 on eof and 1 on buffer size limit met
+// point token_buffer at the next token and return what follows the token's last character
+// e.g. this will return 0 on success read followed by a whitespace and 2 on eof
 int readNextToken() {
-    int ch = ' ';
-    while (isspace(ch)) {
-        if (getNextPos(cur_pos) == last_successful_read) {
-            // too many whitespaces
-            result_token_length = 0;
-            return 1;
-        }
-        ch = readNextChar();
-        if (ch == EOF) {  // encounters EOF without seeing a non-space character
+    // skip the whitespaces
+    while (true) {
+        while (cur_pos < valid_until && isspace((unsigned char)input_buffer[cur_pos]))
+            cur_pos++;
+        if (cur_pos < valid_until)
+            break;
+        if (!fillInputBuffer()) {  // encounters EOF without seeing a non-space character
             // no token read
             result_token_length = 0;
             return 2;
         }
     }
     // read the entire token, and stop when the next space is encountered
-    int n = 0;
+    // the offset from the rewind point survives the buffer being compacted in the middle of a token
+    int64_t tokenOffset = cur_pos - last_successful_read;
+    int result;
     while (true) {
-        token_buffer[n] = (char)ch;
-        n += 1;
-        if (getNextPos(cur_pos) == last_successful_read) {
-            // token too long
-            result_token_length = n;
-            return 1;
+        while (cur_pos < valid_until && !isspace((unsigned char)input_buffer[cur_pos]))
+            cur_pos++;
+        if (cur_pos < valid_until) {
+            result = 0;
+            break;
         }
-        ch = readNextChar();
-        if (ch == EOF || isspace(ch)) {
-            // success, return the token
-            result_token_length = n;
-            return ch == EOF ? 2 : 0;
+        if (!fillInputBuffer()) {
+            result = 2;
+            break;
         }
-        // otherwise keep going
     }
+    token_buffer = input_buffer + last_successful_read + tokenOffset;
+    result_token_length = input_buffer + cur_pos - token_buffer;
+    if (result == 0)
+        cur_pos++;  // the whitespace after the token is read too
+    return result;
 }
 
 ///------------------------------STDIN FOR BASIC TYPES---------------------------------------------------------------
@@ -380,8 +469,6 @@ int32_t readIntegerFromStdin() {
         rewindInputBuffer();
         global_stream_state = 2;
         return false;
-    } else if (result == 1) {  // buffer overflow
-        errorAndExit("Error: Attempt to read an input longer than the input buffer length 1024!");
     } else {
         char ch = token_buffer[0];
         long sign;
@@ -403,7 +490,7 @@ int32_t readIntegerFromStdin() {
             integer = ch - '0';
         }
 
-        int buffer_pos = 1;
+        int64_t buffer_pos = 1;
         // now read the rest of the integer literal until we see a non-digit character
         while (buffer_pos < result_token_length) {
             ch = token_buffer[buffer_pos];
@@ -418,7 +505,7 @@ int32_t readIntegerFromStdin() {
             }
         }
         // success
-        updateRewindPoint(result == 2 ? cur_pos : getPrevPos(cur_pos));
+        updateRewindPoint(result == 2 ? cur_pos : cur_pos - 1);
         rewindInputBuffer();
         global_stream_state = 0;
         return (int32_t)(sign * integer);
@@ -432,8 +519,6 @@ float readRealFromStdin() {
         rewindInputBuffer();
         global_stream_state = 2;
         return false;
-    } else if (result == 1) {  // buffer overflow
-        errorAndExit("Error: Attempt to read an input longer than the input buffer length 1024!");
     } else {
         // represents the current progress in reading the real number
         // 0 = expecting the integer part, 'e' or '.'
@@ -470,7 +555,7 @@ float readRealFromStdin() {
             return 0.0f;
         }
 
-        int buffer_pos = 1;
+        int64_t buffer_pos = 1;
         while (true) {
             if (buffer_pos >= result_token_length) {
                 break;
@@ -543,7 +628,7 @@ float readRealFromStdin() {
             global_stream_state = 1;
             return 0.0f;
         } else {  // success
-            updateRewindPoint(result == 2 ? cur_pos : getPrevPos(cur_pos));
+            updateRewindPoint(result == 2 ? cur_pos : cur_pos - 1);
             rewindInputBuffer();
             global_stream_state = 0;
             return sign * value * powf(10.0f, (float)(exp * expsign));
@@ -558,12 +643,10 @@ bool readBooleanFromStdin() {
         rewindInputBuffer();
         global_stream_state = 2;
         return false;
-    } else if (result == 1) {  // buffer overflow
-        errorAndExit("Error: Attempt to read an input longer than the input buffer length 1024!");
     } else {
         char ch = token_buffer[0];
         if (result_token_length == 1 && (ch == 'T' || ch == 'F')) {  // success
-            updateRewindPoint(result == 2 ? cur_pos : getPrevPos(cur_pos));  // not EOF then there is a whitespace
+            updateRewindPoint(result == 2 ? cur_pos : cur_pos - 1);  // not EOF then there is a whitespace
             rewindInputBuffer();
             global_stream_state = 0;
             return ch == 'T';
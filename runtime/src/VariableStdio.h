@@ -4,6 +4,7 @@
 #include <bits/types/FILE.h>
 #include "Bool.h"
 #include "NDArray.h"
+#include "OutputBuffer.h"
 
 #ifdef DEBUG_PRINT
 extern bool reentry;
@@ -16,7 +17,8 @@ extern int32_t global_stream_state;  // 0, 1, 2 = success, error, eof
 void typeDebugPrint(Type *this);  // debug print to stdout               /// INTERFACE
 void typeInitDebugPrint(Type *this, char *msg);
 
-void elementPrintToFile(FILE *fd, ElementTypeID id, void *value);
+void elementPrintToBuffer(OutputBuffer *buffer, ElementTypeID id, void *value);
+void variablePrintToBuffer(OutputBuffer *buffer, Variable *this);
 void variablePrintToFile(FILE *fd, Variable *this);
 void variablePrintToStream(Variable *this, Variable *stream);            /// INTERFACE
 void variablePrintToStdout(Variable *this);
@@ -24,7 +26,8 @@ void variableDebugPrint(Variable *this);  // debug print to stdout       /// INT
 void variableInitDebugPrint(Variable *this, char *msg);
 
 void variableReadFromStream(Variable *this, Variable *stream);
-void variableReadFromStdin(Variable *this);
+void variableReadFromStdin(Variable *this);  // vectors and matrices read one element per element
+void variableReadArrayFromStdin(Variable *this);
 int32_t readIntegerFromStdin();
 float readRealFromStdin();
 bool readBooleanFromStdin();
@@ -288,6 +288,7 @@ namespace gazprea {
                     t->evalType = symtab->getType(Type::CHARACTER);
                 }
                 break;
+            case Type::INTEGER_INTERVAL:  // indexed like the integer vector it holds
             case Type::INTEGER_1:
                 if (t->children[1]->children[0]->evalType != nullptr 
                 && (t->children[1]->children[0]->evalType->getTypeId() == Type::INTEGER_INTERVAL 
@@ -450,14 +451,20 @@ namespace gazprea {
 
     void TypeWalk::visitFilter(std::shared_ptr<AST> t) {
         isExpressionToReplaceIdentityNull = false;
-        visitChildren(t);
+        visit(t->children[0]);
+        inferDomainVariableType(t->children[0]);
+        visit(t->children[1]);
         t->evalType = symtab->getType(Type::TUPLE);
         t->promoteToType = nullptr;
     }
 
     void TypeWalk::visitGenerator(std::shared_ptr<AST> t) {
         isExpressionToReplaceIdentityNull = false;
-        visitChildren(t);
+        visit(t->children[0]);
+        for (auto domainExpression : t->children[0]->children) {
+            inferDomainVariableType(domainExpression);
+        }
+        visit(t->children[1]);
         t->evalType = nullptr; 
         
         if (t->children[0]->children.size() > 2 ) {
@@ -469,6 +476,33 @@ namespace gazprea {
         t->promoteToType = nullptr;
     }
 
+    // the runtime converts a domain to a vector, so its variable takes the vector's element type
+    void TypeWalk::inferDomainVariableType(std::shared_ptr<AST> t) {
+        auto domainVariableSymbol = std::dynamic_pointer_cast<VariableSymbol>(t->symbol);
+        auto domainType = t->children[1]->evalType;
+        if (domainVariableSymbol == nullptr || domainVariableSymbol->type != nullptr || domainType == nullptr) {
+            return;
+        }
+        switch (domainType->getTypeId()) {
+            case Type::INTEGER_INTERVAL:
+            case Type::INTEGER_1:
+                domainVariableSymbol->type = symtab->getType(Type::INTEGER);
+                break;
+            case Type::REAL_1:
+                domainVariableSymbol->type = symtab->getType(Type::REAL);
+                break;
+            case Type::BOOLEAN_1:
+                domainVariableSymbol->type = symtab->getType(Type::BOOLEAN);
+                break;
+            case Type::CHARACTER_1:
+            case Type::STRING:
+                domainVariableSymbol->type = symtab->getType(Type::CHARACTER);
+                break;
+            default:
+                break;
+        }
+    }
+
     void TypeWalk::visitCast(std::shared_ptr<AST> t) {
         isExpressionToReplaceIdentityNull = false;
         visitChildren(t);
@@ -6,8 +6,12 @@ namespace gazprea
     LLVMGen::LLVMGen(
         std::shared_ptr<SymbolTable> symtab,
         std::shared_ptr<TypePromote> tp,
-        std::string &outfile)
-        : symtab(symtab), globalCtx(), ir(globalCtx), mod("gazprea", globalCtx), outfile(outfile),
+        std::string &outfile,
+        const CodegenOptions &options)
+        : symtab(symtab),
+          threadSafeCtx(std::make_unique<llvm::LLVMContext>()),
+          ownedMod(std::make_unique<llvm::Module>("gazprea", *threadSafeCtx.getContext())),
+          globalCtx(*threadSafeCtx.getContext()), ir(globalCtx), mod(*ownedMod), outfile(outfile), options(options),
           llvmFunction(&globalCtx, &ir, &mod),
           llvmBranch(&globalCtx, &ir, &mod),
           numExprAncestors(0),
@@ -36,7 +40,8 @@ namespace gazprea
         runtimeStackItemTy = llvm::StructType::create(
             globalCtx, {
                 ir.getInt32Ty(),
-                ir.getInt8PtrTy()
+                ir.getInt8PtrTy(),
+                ir.getInt8PtrTy()  // arena chunk
             },
             "RuntimeStackItemTy"
         );
@@ -45,7 +50,9 @@ namespace gazprea
             globalCtx, {
                 ir.getInt64Ty(),
                 ir.getInt64Ty(),
-                runtimeStackItemTy->getPointerTo()
+                runtimeStackItemTy->getPointerTo(),
+                ir.getInt8PtrTy(),  // arena head chunk
+                ir.getInt8PtrTy()   // current arena chunk
             },
             "RuntimeStackTy"
         );
@@ -68,6 +75,7 @@ namespace gazprea
         auto globalVar = mod.getNamedGlobal("globalStack");
         globalVar->setLinkage(llvm::GlobalValue::InternalLinkage);
         globalVar->setInitializer(llvm::ConstantPointerNull::get(runtimeStackTy->getPointerTo()));
+        globalVar->setThreadLocal(true);  // thread pool tasks each get their own stack, see createOutlinedTask
         globalStack = globalVar;
     }
 
@@ -272,10 +280,9 @@ namespace gazprea
             visit(t->children[3]);  // Visit Body
 
             auto runtimeVariableObject = llvmFunction.call("variableMalloc", {});
-            llvmFunction.call("variableInitFromDeclaration", { runtimeVariableObject, t->children[2]->llvmValue, t->children[3]->children[0]->llvmValue });
+            initializeFromDeclarationThenFreeExpression(runtimeVariableObject, t->children[2]->llvmValue, t->children[3]->children[0]);
             llvmFunction.call("typeDestructThenFree", t->children[2]->llvmValue);
             
-            freeExpressionIfNecessary(t->children[3]->children[0]);
             freeSubroutineParameters(subroutineSymbol);
             
             if (subroutineSymbol->name == "gazprea.subroutine.main") {
@@ -320,10 +327,9 @@ namespace gazprea
         isExpressionToReplaceIdentityNull = false;
 
         auto runtimeVariableObject = llvmFunction.call("variableMalloc", {});
-        llvmFunction.call("variableInitFromDeclaration", { runtimeVariableObject, subroutineSymbol->declaration->children[2]->llvmValue, t->children[0]->llvmValue });
+        initializeFromDeclarationThenFreeExpression(runtimeVariableObject, subroutineSymbol->declaration->children[2]->llvmValue, t->children[0]);
         llvmFunction.call("typeDestructThenFree", subroutineSymbol->declaration->children[2]->llvmValue);
         
-        freeExpressionIfNecessary(t->children[0]);
         freeSubroutineParameters(subroutineSymbol);
         
         if (subroutineSymbol->name == "gazprea.subroutine.main") {
@@ -383,10 +389,9 @@ namespace gazprea
             visit(t->children[2]);
             auto runtimeTypeObject = llvmFunction.call("typeMalloc", {});
             llvmFunction.call("typeInitFromUnknownType", { runtimeTypeObject });
-            llvmFunction.call("variableInitFromDeclaration", {runtimeVariableObject, runtimeTypeObject, t->children[2]->llvmValue});
+            initializeFromDeclarationThenFreeExpression(runtimeVariableObject, runtimeTypeObject, t->children[2]);
             variableSymbol->llvmPointerToTypeObject = runtimeTypeObject;
             
-            freeExpressionIfNecessary(t->children[2]);
             llvmFunction.call("typeDestructThenFree", runtimeTypeObject);
         } else {
             auto runtimeTypeObject = t->children[0]->children[1]->llvmValue;
@@ -396,10 +401,9 @@ namespace gazprea
             visit(t->children[2]);
             isExpressionToReplaceIdentityNull = false;
 
-            llvmFunction.call("variableInitFromDeclaration", {runtimeVariableObject, runtimeTypeObject, t->children[2]->llvmValue});
+            initializeFromDeclarationThenFreeExpression(runtimeVariableObject, runtimeTypeObject, t->children[2]);
             variableSymbol->llvmPointerToTypeObject = runtimeTypeObject;
 
-            freeExpressionIfNecessary(t->children[2]);
             llvmFunction.call("typeDestructThenFree", runtimeTypeObject);
         }
         
@@ -411,8 +415,12 @@ namespace gazprea
         visitChildren(t);
         auto numLHSExpressions = t->children[0]->children.size();
         if (numLHSExpressions == 1) {
-            llvmFunction.call("variableAssignment", {t->children[0]->children[0]->llvmValue, t->children[1]->llvmValue});
-            freeExpressionIfNecessary(t->children[1]);
+            if (isTemporaryExpression(t->children[1])) {
+                // the assigned variable takes over the buffers of the temporary
+                llvmFunction.call("variableAssignmentMove", {t->children[0]->children[0]->llvmValue, t->children[1]->llvmValue});
+            } else {
+                llvmFunction.call("variableAssignment", {t->children[0]->children[0]->llvmValue, t->children[1]->llvmValue});
+            }
             freeExpressionIfNecessary(t->children[0]->children[0]);
             return;
         }
@@ -945,49 +953,44 @@ namespace gazprea
 
         auto sp = llvmFunction.call("runtimeStackSave", {getStack()});
         
-        std::vector<llvm::Value*> domainIndexVars;
-        std::vector<llvm::Value*> domainExprs;
+        // the position in each domain is a native counter, an integer sequence domain (see isLazyIntegerSequence) is
+        // never turned into a vector and its value is head + position * step
+        std::vector<llvm::Value*> domainIndexSlots;
+        std::vector<llvm::Value*> domainExprs;  // nullptr for an interval domain
+        std::vector<llvm::Value*> domainHeads;  // nullptr for a vector domain
+        std::vector<llvm::Value*> domainSteps;  // nullptr for a vector domain
         std::vector<llvm::Value*> domainExprSizes;
         std::vector<llvm::Value*> domainVars;
 
-        // Constants for all loops
-        auto indexVariableType = llvmFunction.call("typeStackAllocate", {getStack()});
-        llvmFunction.call("typeInitFromIntegerScalar", {indexVariableType});
-
-        auto constOne = llvmFunction.call("variableStackAllocate", {getStack()});
-        llvmFunction.call("variableInitFromIntegerScalar", {constOne, ir.getInt32(1)});
- 
-        // auto constZero = llvmFunction.call("variableStackAllocate", {getStack()});
-        // llvmFunction.call("variableInitFromIntegerScalar", {constZero, ir.getInt32(0)});
-
-        auto constNegativeOne = llvmFunction.call("variableStackAllocate", {getStack()});
-        llvmFunction.call("variableInitFromIntegerScalar", {constNegativeOne, ir.getInt32(-1)});
- 
         // Create Preheader and necessary vectors
         for (size_t i = 0; i < t->children.size()-1; i++) {
-            // create index variable & set to 0
-            auto indexInitialization = llvmFunction.call("variableStackAllocate", {getStack()}); 
-            auto indexVariable = llvmFunction.call("variableStackAllocate", {getStack()});
-            llvmFunction.call("variableInitFromIntegerScalar", {indexInitialization, ir.getInt32(-1)});
-            llvmFunction.call("variableInitFromDeclaration", {indexVariable, indexVariableType, indexInitialization}); 
-            domainIndexVars.push_back(indexVariable);
+            // create index & set to -1, the header increments it before the first iteration
+            auto indexSlot = createEntryBlockAlloca(ir.getInt64Ty());
+            ir.CreateStore(ir.getInt64(-1), indexSlot);
+            domainIndexSlots.push_back(indexSlot);
 
             // Initialize domain expressions & push to vector
-            visit(t->children[i]);
             auto domainExpr = t->children[i]->children[1];
-            auto runtimeDomainArray = llvmFunction.call("variableStackAllocate", {getStack()});
-            llvmFunction.call("variableInitFromDomainExpression", {runtimeDomainArray, domainExpr->llvmValue});
-            if (domainExpr->getNodeType() == GazpreaParser::EXPRESSION_TOKEN) { //free is not id
-                freeExpressionIfNecessary(domainExpr); 
-            } 
-            domainExprs.push_back(runtimeDomainArray);
-
-            // Calculate size of each domain array and store in vector 
-            llvm::Value *length = llvmFunction.call("variableGetLength", {runtimeDomainArray});
-            llvm::Value *truncLength = ir.CreateIntCast(length, ir.getInt32Ty(), true);
-            auto lengthVariable = llvmFunction.call("variableStackAllocate", {getStack()});
-            llvmFunction.call("variableInitFromIntegerScalar", {lengthVariable, truncLength}); 
-            domainExprSizes.push_back(lengthVariable);
+            llvm::Value *length;
+            if (domainExpr->getNodeType() == GazpreaParser::EXPRESSION_TOKEN && isLazyIntegerSequence(domainExpr->children[0])) {
+                llvm::Value *head, *step;
+                generateLazyIntegerSequence(domainExpr->children[0], head, step, length);
+                domainHeads.push_back(head);
+                domainSteps.push_back(step);
+                domainExprs.push_back(nullptr);
+            } else {
+                visit(t->children[i]);
+                auto runtimeDomainArray = llvmFunction.call("variableStackAllocate", {getStack()});
+                llvmFunction.call("variableInitFromDomainExpression", {runtimeDomainArray, domainExpr->llvmValue});
+                length = llvmFunction.call("variableGetLength", {runtimeDomainArray});
+                domainHeads.push_back(nullptr);
+                domainSteps.push_back(nullptr);
+                domainExprs.push_back(runtimeDomainArray);
+                if (domainExpr->getNodeType() == GazpreaParser::EXPRESSION_TOKEN) { //free is not id
+                    freeExpressionIfNecessary(domainExpr);
+                }
+            }
+            domainExprSizes.push_back(length);
 
             //speculative domain variable declaration to satisfy LLVM dominator constraint
             auto domainVar = llvmFunction.call("variableMalloc", {});
@@ -1031,17 +1034,16 @@ namespace gazprea
 
                 ir.SetInsertPoint(header_i);
                 //reset the next header array index and domain variable to initial values 
-                auto next_loop_index = domainIndexVars[i+1];
-                llvmFunction.call("variableReplace", {next_loop_index, constNegativeOne});
+                ir.CreateStore(ir.getInt64(-1), domainIndexSlots[i+1]);
                 branchTrue = next_header;
                 branchFalse = merge_i;
             }
 
-            //create comparisson between index variable and length of domain vector
-            auto indexVariable = domainIndexVars[i];
-            auto lengthVariable = domainExprSizes[i];
-            incrementIndex(indexVariable, 1); 
-            llvm::Value* branchCond = createBranchCondition(indexVariable, lengthVariable);
+            //create comparisson between index and length of domain
+            auto indexSlot = domainIndexSlots[i];
+            auto nextIndex = ir.CreateAdd(ir.CreateLoad(ir.getInt64Ty(), indexSlot), ir.getInt64(1));
+            ir.CreateStore(nextIndex, indexSlot);
+            llvm::Value* branchCond = ir.CreateICmpSLT(nextIndex, domainExprSizes[i]);
             ir.CreateCondBr(branchCond, branchTrue, branchFalse);
         }
         // Create Body and Merge Blocks
@@ -1062,15 +1064,20 @@ namespace gazprea
             int numChildren = t->children.size();
             if (i == numChildren-2) {
                 for (size_t j = 0; j < t->children.size()-1; j++ ) {
-                    auto indexVariable = domainIndexVars[j];
-                    auto runtimeDomainArray = domainExprs[j];
                     auto runtimeDomainVar = domainVars[j];
-                    llvm::Value* index_i32 = llvmFunction.call("variableGetIntegerValue", {indexVariable});
-                    llvm::Value* index_i64 = ir.CreateIntCast(index_i32, ir.getInt64Ty(), false); 
+                    llvm::Value* index_i64 = ir.CreateLoad(ir.getInt64Ty(), domainIndexSlots[j]);
                     
                     //init domain variable & variable symbol
                     auto variableAST = t->children[j]->children[0];
-                    initializeDomainVariable(runtimeDomainVar, runtimeDomainArray, index_i64); 
+                    if (domainHeads[j] != nullptr) {
+                        // the domain variable stays an integer scalar even if the body assigns to it, so the value is
+                        // written into it in place; m_data is reloaded since an assignment replaces it
+                        auto offset = ir.CreateMul(ir.CreateTrunc(index_i64, ir.getInt32Ty()), domainSteps[j]);
+                        auto value = ir.CreateAdd(domainHeads[j], offset);
+                        storeUnboxedArrayElement(getUnboxedArrayData(runtimeDomainVar, Type::INTEGER), ir.getInt64(0), value, Type::INTEGER);
+                    } else {
+                        initializeDomainVariable(runtimeDomainVar, domainExprs[j], index_i64); 
+                    }
                     initializeVariableSymbol(variableAST, runtimeDomainVar); 
                 }
                 llvmBranch.hitReturnStat = false;
@@ -1145,15 +1152,44 @@ namespace gazprea
         t->llvmValue = runtimeVariableObject;
     }
 
+    // the value of an integer literal, used by both the boxed and the unboxed scalar paths
+    int32_t LLVMGen::parseIntegerLiteral(std::shared_ptr<AST> t) {
+        std::string text = t->parseTree->getText();
+        auto *ctx = dynamic_cast<antlr4::ParserRuleContext*>(t->parseTree);
+        try {
+            size_t length;
+            long value = std::stol(text, &length);
+            if (length == text.size() && value >= INT32_MIN && value <= INT32_MAX)
+                return (int32_t)value;
+        } catch (std::logic_error &) {  // std::invalid_argument or std::out_of_range
+        }
+        throw GazpreaError("Integer literal out of range: ", text, text,
+            ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine());
+    }
+
+    // the value of a real literal, used by both the boxed and the unboxed scalar paths
+    float LLVMGen::parseRealLiteral(std::shared_ptr<AST> t) {
+        std::string text = t->parseTree->getText();
+        auto *ctx = dynamic_cast<antlr4::ParserRuleContext*>(t->parseTree);
+        // strtof instead of std::stof, which throws on literals too small for a float instead of rounding them
+        char *end;
+        float value = std::strtof(text.c_str(), &end);
+        if (*end != '\0' || std::isinf(value)) {
+            throw GazpreaError("Real literal out of range: ", text, text,
+                ctx->getStart()->getLine(), ctx->getStart()->getCharPositionInLine());
+        }
+        return value;
+    }
+
     void LLVMGen::visitIntegerAtom(std::shared_ptr<AST> t) {
-        auto integerValue = std::stoi(t->parseTree->getText());
+        auto integerValue = parseIntegerLiteral(t);
         auto runtimeVariableObject = llvmFunction.call("variableMalloc", {});
         llvmFunction.call("variableInitFromIntegerScalar", {runtimeVariableObject, ir.getInt32(integerValue)});
         t->llvmValue = runtimeVariableObject;
     }
 
     void LLVMGen::visitRealAtom(std::shared_ptr<AST> t) {
-        auto realValue = std::stof(t->parseTree->getText());
+        auto realValue = parseRealLiteral(t);
         auto runtimeVariableObject = llvmFunction.call("variableMalloc", {});
         llvmFunction.call("variableInitFromRealScalar", {runtimeVariableObject, llvm::ConstantFP::get(ir.getFloatTy(), realValue)});
         t->llvmValue = runtimeVariableObject;
@@ -1225,6 +1261,9 @@ namespace gazprea
     }
 
     void LLVMGen::visitGenerator(std::shared_ptr<AST> t) {  
+        // when the element type is known, results are stored natively into a packed buffer instead of boxed variables
+        int elementTypeId = getUnboxedScalarTypeId(t->children[1]);
+        bool isTyped = elementTypeId != -1;
         if (t->children[0]->children.size() ==  1) { 
             // create basic blocks            
             llvm::Function* parentFunc = ir.GetInsertBlock()->getParent();
@@ -1259,9 +1298,54 @@ namespace gazprea
             auto lengthVariable = llvmFunction.call("variableMalloc", {});
             llvmFunction.call("variableInitFromIntegerScalar", {lengthVariable, truncLength});
             // create the result vector
-            auto generatorArray = llvmFunction.call("variableArrayMalloc", {length}); //result vector i
+            llvm::Value *generatorArray = nullptr;
+            llvm::Value *generatorArrayVar = nullptr;
+            llvm::Value *generatorData = nullptr;
+            if (isTyped) {
+                generatorArrayVar = llvmFunction.call("variableMalloc", {});
+                llvmFunction.call("variableInitFromTypedGeneratorVector", {generatorArrayVar, ir.getInt32(getRuntimeElementTypeId(elementTypeId)), length});
+                generatorData = getUnboxedArrayData(generatorArrayVar, elementTypeId);
+            } else {
+                generatorArray = llvmFunction.call("variableArrayMalloc", {length}); //result vector i
+            }
             // move onto header  
-            ir.CreateBr(header);
+            std::vector<std::shared_ptr<AST>> identifiers;
+            if (isTyped && isParallelComprehension({t->children[1]}, identifiers)) {
+                auto domainSymbol = t->children[0]->children[0]->symbol;
+                int domainTypeId;
+                auto domainData = getParallelDomainData(domainSymbol, runtimeDomainArray, identifiers, domainTypeId);
+                llvm::BasicBlock* parallel = llvm::BasicBlock::Create(globalCtx, "generatorParallel", parentFunc);
+                if (domainData != nullptr) {
+                    // fall back to the serial loop if the domain is not a vector of the expected type
+                    ir.CreateCondBr(ir.CreateIsNotNull(domainData), parallel, header);
+                } else {
+                    ir.CreateBr(parallel);
+                }
+                ir.SetInsertPoint(parallel);
+
+                std::vector<llvm::Value*> captures = {generatorData, domainData != nullptr ? domainData : generatorData};
+                std::vector<std::shared_ptr<Symbol>> capturedSymbols;
+                captureOutlinedIdentifiers(identifiers, {domainSymbol}, captures, capturedSymbols);
+                llvm::Value* taskArg;
+                auto task = createOutlinedTask("generatorTask", captures, taskArg,
+                [&](const std::vector<llvm::Value*> &fields, llvm::Value* begin, llvm::Value* end) {
+                    for (size_t i = 0; i < capturedSymbols.size(); i++) {
+                        unboxedSymbolValues[capturedSymbols[i]] = fields[2 + i];
+                    }
+                    createNativeLoop(begin, end, [&](llvm::Value* index) {
+                        if (domainData != nullptr) {
+                            unboxedSymbolValues[domainSymbol] = loadUnboxedArrayElement(fields[1], index, domainTypeId);
+                        }
+                        auto value = generateUnboxedScalar(t->children[1]->children[0], elementTypeId);
+                        storeUnboxedArrayElement(fields[0], index, value, elementTypeId);
+                    });
+                    unboxedSymbolValues.clear();
+                });
+                llvmFunction.call("threadPoolParallelFor", {ir.getInt64(0), length, ir.getInt64(PARALLEL_COMPREHENSION_GRAIN), task, taskArg});
+                ir.CreateBr(merge);
+            } else {
+                ir.CreateBr(header);
+            }
             ir.SetInsertPoint(header);
 
             // compare current index with length of domain vector    
@@ -1279,14 +1363,18 @@ namespace gazprea
             //initialize variable symbol to from variable at current index in domain array
             auto variableAST = t->children[0]->children[0]->children[0]; 
             initializeVariableSymbol(variableAST, runtimeDomainVar);  
-            visit(t->children[1]); //evaluate RHS expression with current domain variable value 
+            if (isTyped) {
+                auto value = generateUnboxedScalar(t->children[1]->children[0], elementTypeId);
+                storeUnboxedArrayElement(generatorData, index_i64, value, elementTypeId);
+                llvmFunction.call("variableDestructThenFree", {runtimeDomainVar});
+            } else {
+                visit(t->children[1]); //evaluate RHS expression with current domain variable value 
 
-            auto exprVar = llvmFunction.call("variableMalloc", {});
-            llvmFunction.call("variableInitFromMemcpy", {exprVar, t->children[1]->llvmValue});
-            llvmFunction.call("variableArraySet", {generatorArray, index_i64, exprVar}); 
-            // free what we can
-            llvmFunction.call("variableDestructThenFree", {runtimeDomainVar});
-            freeExpressionIfNecessary(t->children[1]);
+                auto exprVar = moveOrCopyExpression(t->children[1]);
+                llvmFunction.call("variableArraySet", {generatorArray, index_i64, exprVar}); 
+                // free what we can
+                llvmFunction.call("variableDestructThenFree", {runtimeDomainVar});
+            }
 
             //increment the index variable
             incrementIndex(indexVariable, 1); 
@@ -1294,15 +1382,19 @@ namespace gazprea
             ir.SetInsertPoint(merge);
 
             // assign result array to AST
-            auto generatorArrayVar = llvmFunction.call("variableMalloc", {});
-            llvmFunction.call("variableInitFromVectorLiteral", { generatorArrayVar, length, generatorArray }); 
+            if (!isTyped) {
+                generatorArrayVar = llvmFunction.call("variableMalloc", {});
+                llvmFunction.call("variableInitFromVectorLiteral", { generatorArrayVar, length, generatorArray }); 
+            }
             t->llvmValue = generatorArrayVar;
             //free mallocs
             llvmFunction.call("variableDestructThenFree", {indexVariable});
             llvmFunction.call("variableDestructThenFree", {lengthVariable});
             llvmFunction.call("variableDestructThenFree", {runtimeDomainArray});
-            llvmFunction.call("freeArrayContents", {generatorArray, length});
-            llvmFunction.call("variableArrayFree", {generatorArray});
+            if (!isTyped) {
+                llvmFunction.call("freeArrayContents", {generatorArray, length});
+                llvmFunction.call("variableArrayFree", {generatorArray});
+            }
             llvmFunction.call("typeDestructThenFree", {indexVariableType});
  
         } else if (t->children[0]->children.size() == 2) { 
@@ -1364,14 +1456,81 @@ namespace gazprea
             llvmFunction.call("variableInitFromIntegerScalar", {innerDomainLengthVar, truncInnerDomainLength});
 
             //result matrix 
-            auto generatorMatrix = llvmFunction.call("variableArrayMalloc", {outerDomainLength}); //result vector i 
-            ir.CreateBr(outerHeader);
+            llvm::Value *generatorMatrix = nullptr;
+            llvm::Value *generatorMatrixVariable = nullptr;
+            llvm::Value *generatorData = nullptr;
+            if (isTyped) {
+                generatorMatrixVariable = llvmFunction.call("variableMalloc", {});
+                llvmFunction.call("variableInitFromTypedGeneratorMatrix", {generatorMatrixVariable, ir.getInt32(getRuntimeElementTypeId(elementTypeId)), outerDomainLength, innerDomainLength});
+                generatorData = getUnboxedArrayData(generatorMatrixVariable, elementTypeId);
+            } else {
+                generatorMatrix = llvmFunction.call("variableArrayMalloc", {outerDomainLength}); //result vector i 
+            }
+            std::vector<std::shared_ptr<AST>> identifiers;
+            if (isTyped && isParallelComprehension({t->children[1]}, identifiers)) {
+                auto outerSymbol = t->children[0]->children[0]->symbol;
+                auto innerSymbol = t->children[0]->children[1]->symbol;
+                int outerTypeId, innerTypeId;
+                auto outerData = getParallelDomainData(outerSymbol, outerRuntimeDomainArray, identifiers, outerTypeId);
+                auto innerData = getParallelDomainData(innerSymbol, innerRuntimeDomainArray, identifiers, innerTypeId);
+                llvm::BasicBlock* parallel = llvm::BasicBlock::Create(globalCtx, "generatorMatrixParallel", parentFunc);
+                // fall back to the serial loops if a domain is not a vector of the expected type
+                llvm::Value* canRunParallel = ir.getTrue();
+                if (outerData != nullptr) {
+                    canRunParallel = ir.CreateAnd(canRunParallel, ir.CreateIsNotNull(outerData));
+                }
+                if (innerData != nullptr) {
+                    canRunParallel = ir.CreateAnd(canRunParallel, ir.CreateIsNotNull(innerData));
+                }
+                ir.CreateCondBr(canRunParallel, parallel, outerHeader);
+                ir.SetInsertPoint(parallel);
+
+                std::vector<llvm::Value*> captures = {
+                    generatorData,
+                    outerData != nullptr ? outerData : generatorData,
+                    innerData != nullptr ? innerData : generatorData,
+                    innerDomainLength
+                };
+                std::vector<std::shared_ptr<Symbol>> capturedSymbols;
+                captureOutlinedIdentifiers(identifiers, {outerSymbol, innerSymbol}, captures, capturedSymbols);
+                llvm::Value* taskArg;
+                // each task fills whole rows
+                auto task = createOutlinedTask("generatorMatrixTask", captures, taskArg,
+                [&](const std::vector<llvm::Value*> &fields, llvm::Value* begin, llvm::Value* end) {
+                    for (size_t i = 0; i < capturedSymbols.size(); i++) {
+                        unboxedSymbolValues[capturedSymbols[i]] = fields[4 + i];
+                    }
+                    createNativeLoop(begin, end, [&](llvm::Value* row) {
+                        if (outerData != nullptr) {
+                            unboxedSymbolValues[outerSymbol] = loadUnboxedArrayElement(fields[1], row, outerTypeId);
+                        }
+                        createNativeLoop(ir.getInt64(0), fields[3], [&](llvm::Value* col) {
+                            if (innerData != nullptr) {
+                                unboxedSymbolValues[innerSymbol] = loadUnboxedArrayElement(fields[2], col, innerTypeId);
+                            }
+                            auto position = ir.CreateAdd(ir.CreateMul(row, fields[3]), col);
+                            auto value = generateUnboxedScalar(t->children[1]->children[0], elementTypeId);
+                            storeUnboxedArrayElement(fields[0], position, value, elementTypeId);
+                        });
+                    });
+                    unboxedSymbolValues.clear();
+                });
+                auto rowLength = ir.CreateSelect(ir.CreateICmpSGT(innerDomainLength, ir.getInt64(0)), innerDomainLength, ir.getInt64(1));
+                auto grain = ir.CreateSDiv(ir.getInt64(PARALLEL_COMPREHENSION_GRAIN), rowLength);
+                llvmFunction.call("threadPoolParallelFor", {ir.getInt64(0), outerDomainLength, grain, task, taskArg});
+                ir.CreateBr(outerMerge);
+            } else {
+                ir.CreateBr(outerHeader);
+            }
             ir.SetInsertPoint(outerHeader); 
             llvm::Value *branchCond = createBranchCondition(outerIndex, outerDomainLengthVar);
             ir.CreateCondBr(branchCond, innerPreHeader, outerMerge); 
             
             ir.SetInsertPoint(innerPreHeader);
-            auto matrixRow = llvmFunction.call("variableArrayMalloc", {innerDomainLength});
+            llvm::Value *matrixRow = nullptr;
+            if (!isTyped) {
+                matrixRow = llvmFunction.call("variableArrayMalloc", {innerDomainLength});
+            }
             llvmFunction.call("variableReplace", {innerIndex, constZero});
             ir.CreateBr(innerHeader);
             ir.SetInsertPoint(innerHeader); 
@@ -1398,24 +1557,31 @@ namespace gazprea
             initializeVariableSymbol(outerVarAST, runtimeOuterDomainVar); 
             initializeVariableSymbol(innerVarAST, runtimeInnerDomainVar);  
 
-            visit(t->children[1]);
-            
-            //set row to computed value
-            auto exprVar = llvmFunction.call("variableMalloc", {});
-            llvmFunction.call("variableInitFromMemcpy", {exprVar, t->children[1]->llvmValue});
-            llvmFunction.call("variableArraySet", {matrixRow, innerIndex_i64, exprVar});
-            freeExpressionIfNecessary(t->children[1]);
+            if (isTyped) {
+                // row major position in the packed result
+                auto position = ir.CreateAdd(ir.CreateMul(outerIndex_i64, innerDomainLength), innerIndex_i64);
+                auto value = generateUnboxedScalar(t->children[1]->children[0], elementTypeId);
+                storeUnboxedArrayElement(generatorData, position, value, elementTypeId);
+            } else {
+                visit(t->children[1]);
+                
+                //set row to computed value
+                auto exprVar = moveOrCopyExpression(t->children[1]);
+                llvmFunction.call("variableArraySet", {matrixRow, innerIndex_i64, exprVar});
+            }
 
             incrementIndex(innerIndex, 1); // increment the inner index
             ir.CreateBr(innerHeader);
             ir.SetInsertPoint(innerMerge);
             
             // variable init from vector literal & set into generator matrix [outer index] 
-            auto matrixRowVariable = llvmFunction.call("variableMalloc", {});
-            llvmFunction.call("variableInitFromVectorLiteral", { matrixRowVariable, innerDomainLength, matrixRow });
-            llvmFunction.call("variableArraySet", {generatorMatrix, outerIndex_i64, matrixRowVariable});
-            llvmFunction.call("freeArrayContents", {matrixRow, innerDomainLength});
-            llvmFunction.call("variableArrayFree", {matrixRow});
+            if (!isTyped) {
+                auto matrixRowVariable = llvmFunction.call("variableMalloc", {});
+                llvmFunction.call("variableInitFromVectorLiteral", { matrixRowVariable, innerDomainLength, matrixRow });
+                llvmFunction.call("variableArraySet", {generatorMatrix, outerIndex_i64, matrixRowVariable});
+                llvmFunction.call("freeArrayContents", {matrixRow, innerDomainLength});
+                llvmFunction.call("variableArrayFree", {matrixRow});
+            }
 
             ir.CreateBr(outerBody);
             ir.SetInsertPoint(outerBody);
@@ -1424,8 +1590,10 @@ namespace gazprea
             ir.CreateBr(outerHeader);
             ir.SetInsertPoint(outerMerge);
  
-            auto generatorMatrixVariable = llvmFunction.call("variableMalloc", {});
-            llvmFunction.call("variableInitFromVectorLiteral", { generatorMatrixVariable , outerDomainLength, generatorMatrix });
+            if (!isTyped) {
+                generatorMatrixVariable = llvmFunction.call("variableMalloc", {});
+                llvmFunction.call("variableInitFromVectorLiteral", { generatorMatrixVariable , outerDomainLength, generatorMatrix });
+            }
             t->llvmValue = generatorMatrixVariable;
 
             // low hanging fruits
@@ -1437,8 +1605,10 @@ namespace gazprea
             llvmFunction.call("variableDestructThenFree", {innerDomainLengthVar});
             llvmFunction.call("variableDestructThenFree", {outerRuntimeDomainArray});
             llvmFunction.call("variableDestructThenFree", {innerRuntimeDomainArray});
-            llvmFunction.call("freeArrayContents", {generatorMatrix, outerDomainLength});
-            llvmFunction.call("variableArrayFree", {generatorMatrix});
+            if (!isTyped) {
+                llvmFunction.call("freeArrayContents", {generatorMatrix, outerDomainLength});
+                llvmFunction.call("variableArrayFree", {generatorMatrix});
+            }
             llvmFunction.call("variableDestructThenFree", {t->children[0]->children[0]->llvmValue});
             llvmFunction.call("variableDestructThenFree", {t->children[0]->children[1]->llvmValue});
         }  
@@ -1479,6 +1649,228 @@ namespace gazprea
         llvmFunction.call("variableDestructThenFree", {constIncrement});
     }
 
+    // true if t only has constants, scalar identifiers and natively computable operations that cannot fail, so it can
+    // run outside the runtime; the identifiers it reads are appended to identifiers
+    bool LLVMGen::collectOutlinableIdentifiers(std::shared_ptr<AST> t, std::vector<std::shared_ptr<AST>> &identifiers) {
+        int operandTypeId;
+        switch (t->getNodeType()) {
+            case GazpreaParser::IntegerConstant:
+            case GazpreaParser::REAL_CONSTANT_TOKEN:
+            case GazpreaParser::BooleanConstant:
+                return getUnboxedScalarTypeId(t) != -1;
+            case GazpreaParser::IDENTIFIER_TOKEN:
+                if (getUnboxedScalarTypeId(t) == -1) {
+                    return false;
+                }
+                identifiers.push_back(t);
+                return true;
+            case GazpreaParser::BINARY_OP_TOKEN:
+                if (getUnboxedBinaryOperationTypeId(t, operandTypeId) == -1) {
+                    return false;
+                }
+                // integer / and % exit on a zero divisor, which must not happen on a worker thread
+                if (operandTypeId == Type::INTEGER && (t->children[2]->getNodeType() == GazpreaParser::DIV
+                    || t->children[2]->getNodeType() == GazpreaParser::MODULO)) {
+                    return false;
+                }
+                return collectOutlinableIdentifiers(t->children[0], identifiers)
+                    && collectOutlinableIdentifiers(t->children[1], identifiers);
+            case GazpreaParser::UNARY_TOKEN:
+                return getUnboxedUnaryOperationTypeId(t) != -1
+                    && collectOutlinableIdentifiers(t->children[1], identifiers);
+            case GazpreaParser::CALL_PROCEDURE_FUNCTION_IN_EXPRESSION: {
+                // a function with scalar arguments and result, called with boxed copies on the worker's own RuntimeStack
+                auto subroutineSymbol = std::dynamic_pointer_cast<SubroutineSymbol>(t->children[0]->symbol);
+                if (getUnboxedScalarTypeId(t) == -1 || !isThreadSafeFunction(subroutineSymbol)
+                || t->children[1]->children.size() != subroutineSymbol->orderedArgs.size()) {
+                    return false;
+                }
+                for (auto expressionAST : t->children[1]->children) {
+                    if (getUnboxedScalarTypeId(expressionAST->children[0]) == -1
+                    || !collectOutlinableIdentifiers(expressionAST->children[0], identifiers)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    // true if a user function can run on a worker thread: neither it nor anything it calls reads a global variable,
+    // whose buffers other threads share without atomic reference counts, or touches a stream
+    bool LLVMGen::isThreadSafeFunction(std::shared_ptr<Symbol> symbol) {
+        auto subroutineSymbol = std::dynamic_pointer_cast<SubroutineSymbol>(symbol);
+        if (subroutineSymbol == nullptr || subroutineSymbol->isBuiltIn || subroutineSymbol->isProcedure
+        || subroutineSymbol->definition == nullptr) {
+            return false;
+        }
+        auto found = threadSafeFunctions.find(subroutineSymbol);
+        if (found != threadSafeFunctions.end()) {
+            return found->second;
+        }
+        std::set<std::shared_ptr<Symbol>> visitedFunctions = {subroutineSymbol};
+        bool isThreadSafe = isThreadSafeSubtree(subroutineSymbol->definition, visitedFunctions);
+        threadSafeFunctions[subroutineSymbol] = isThreadSafe;
+        return isThreadSafe;
+    }
+
+    bool LLVMGen::isThreadSafeSubtree(std::shared_ptr<AST> t, std::set<std::shared_ptr<Symbol>> &visitedFunctions) {
+        if (t->getNodeType() == GazpreaParser::INPUT_STREAM_TOKEN || t->getNodeType() == GazpreaParser::OUTPUT_STREAM_TOKEN) {
+            return false;
+        }
+        auto variableSymbol = std::dynamic_pointer_cast<VariableSymbol>(t->symbol);
+        if (variableSymbol != nullptr && variableSymbol->isGlobalVariable) {
+            return false;
+        }
+        if (t->getNodeType() == GazpreaParser::CALL_PROCEDURE_FUNCTION_IN_EXPRESSION
+        || t->getNodeType() == GazpreaParser::CALL_PROCEDURE_STATEMENT_TOKEN) {
+            auto subroutineSymbol = std::dynamic_pointer_cast<SubroutineSymbol>(t->children[0]->symbol);
+            if (subroutineSymbol == nullptr) {
+                return false;
+            }
+            if (subroutineSymbol->isBuiltIn) {
+                if (subroutineSymbol->name == "gazprea.subroutine.stream_state") {
+                    return false;
+                }
+            } else if (visitedFunctions.count(subroutineSymbol) == 0) {
+                visitedFunctions.insert(subroutineSymbol);
+                if (subroutineSymbol->isProcedure || subroutineSymbol->definition == nullptr
+                || !isThreadSafeSubtree(subroutineSymbol->definition, visitedFunctions)) {
+                    return false;
+                }
+            }
+        }
+        for (auto child : t->children) {
+            if (!isThreadSafeSubtree(child, visitedFunctions)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // a comprehension runs on the thread pool when it is enabled and every body (an expression node) can be outlined
+    bool LLVMGen::isParallelComprehension(const std::vector<std::shared_ptr<AST>> &bodies, std::vector<std::shared_ptr<AST>> &identifiers) {
+        if (!options.parallelComprehensions) {
+            return false;
+        }
+        for (auto body : bodies) {
+            if (!collectOutlinableIdentifiers(body->children[0], identifiers)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // the native data of a domain if the comprehension reads its variable, null if that variable is unused
+    // domainTypeId is set to the type of the domain variable, and the data is null at runtime if the domain is not stored that way
+    llvm::Value* LLVMGen::getParallelDomainData(std::shared_ptr<Symbol> domainSymbol, llvm::Value* runtimeDomainArray,
+                                                const std::vector<std::shared_ptr<AST>> &identifiers, int &domainTypeId) {
+        domainTypeId = -1;
+        for (auto identifier : identifiers) {
+            if (identifier->symbol == domainSymbol) {
+                domainTypeId = getUnboxedScalarTypeId(identifier);
+                break;
+            }
+        }
+        if (domainTypeId == -1) {
+            return nullptr;
+        }
+        auto data = llvmFunction.call("variableGetConcreteVectorData", {runtimeDomainArray, ir.getInt32(getRuntimeElementTypeId(domainTypeId))});
+        return ir.CreateBitCast(data, getUnboxedElementStorageType(domainTypeId)->getPointerTo());
+    }
+
+    llvm::Value* LLVMGen::loadUnboxedArrayElement(llvm::Value* arrayData, llvm::Value* index, int typeId) {
+        llvm::Type* storageType = getUnboxedElementStorageType(typeId);
+        auto value = ir.CreateLoad(storageType, ir.CreateInBoundsGEP(storageType, arrayData, index));
+        if (typeId == Type::BOOLEAN) {
+            return ir.CreateICmpNE(value, ir.getInt32(0));
+        }
+        return value;
+    }
+
+    // emit a native counted loop over [begin, end) at the current insert point
+    void LLVMGen::createNativeLoop(llvm::Value* begin, llvm::Value* end, const std::function<void(llvm::Value*)> &emitBody) {
+        llvm::Function* parentFunc = ir.GetInsertBlock()->getParent();
+        llvm::BasicBlock* preHeader = ir.GetInsertBlock();
+        llvm::BasicBlock* header = llvm::BasicBlock::Create(globalCtx, "nativeLoopHeader", parentFunc);
+        llvm::BasicBlock* body = llvm::BasicBlock::Create(globalCtx, "nativeLoopBody", parentFunc);
+        llvm::BasicBlock* merge = llvm::BasicBlock::Create(globalCtx, "nativeLoopMerge", parentFunc);
+
+        ir.CreateBr(header);
+        ir.SetInsertPoint(header);
+        llvm::PHINode* index = ir.CreatePHI(ir.getInt64Ty(), 2);
+        index->addIncoming(begin, preHeader);
+        ir.CreateCondBr(ir.CreateICmpSLT(index, end), body, merge);
+
+        ir.SetInsertPoint(body);
+        emitBody(index);
+        auto nextIndex = ir.CreateAdd(index, ir.getInt64(1));
+        index->addIncoming(nextIndex, ir.GetInsertBlock());
+        ir.CreateBr(header);
+        ir.SetInsertPoint(merge);
+    }
+
+    // outline a ThreadPoolTask that receives the captured values through taskArg and runs emitRange on [begin, end)
+    // the insert point is restored to where it was when this returns
+    llvm::Function* LLVMGen::createOutlinedTask(const std::string &name, const std::vector<llvm::Value*> &captures, llvm::Value* &taskArg,
+                                                const std::function<void(const std::vector<llvm::Value*>&, llvm::Value*, llvm::Value*)> &emitRange) {
+        std::vector<llvm::Type*> captureTypes;
+        for (auto capture : captures) {
+            captureTypes.push_back(capture->getType());
+        }
+        llvm::StructType* captureTy = llvm::StructType::get(globalCtx, captureTypes);
+
+        // the captures live in the caller's frame, which outlives the parallel for
+        llvm::Function* parentFunc = ir.GetInsertBlock()->getParent();
+        llvm::IRBuilder<> entryBuilder(&parentFunc->getEntryBlock(), parentFunc->getEntryBlock().begin());
+        auto captureStruct = entryBuilder.CreateAlloca(captureTy);
+        for (size_t i = 0; i < captures.size(); i++) {
+            ir.CreateStore(captures[i], ir.CreateStructGEP(captureTy, captureStruct, i));
+        }
+        taskArg = ir.CreateBitCast(captureStruct, ir.getInt8PtrTy());
+
+        auto taskTy = llvm::FunctionType::get(ir.getVoidTy(), {ir.getInt8PtrTy(), ir.getInt64Ty(), ir.getInt64Ty()}, false);
+        auto task = llvm::Function::Create(taskTy, llvm::GlobalValue::InternalLinkage, name, mod);
+        auto savedIP = ir.saveIP();
+        llvm::BasicBlock* enterTask = llvm::BasicBlock::Create(globalCtx, "enterTask", task);
+        llvm::BasicBlock* initStack = llvm::BasicBlock::Create(globalCtx, "initTaskStack", task);
+        llvm::BasicBlock* runTask = llvm::BasicBlock::Create(globalCtx, "runTask", task);
+        // a worker thread runs its first task with a null stack pointer, the issuing thread keeps the one it has
+        ir.SetInsertPoint(enterTask);
+        ir.CreateCondBr(ir.CreateIsNull(getStack()), initStack, runTask);
+        ir.SetInsertPoint(initStack);
+        ir.CreateStore(llvmFunction.call("runtimeStackGetThreadLocal", {}), globalStack);
+        ir.CreateBr(runTask);
+        ir.SetInsertPoint(runTask);
+        auto argStruct = ir.CreateBitCast(task->getArg(0), captureTy->getPointerTo());
+        std::vector<llvm::Value*> fields;
+        for (size_t i = 0; i < captures.size(); i++) {
+            fields.push_back(ir.CreateLoad(captureTypes[i], ir.CreateStructGEP(captureTy, argStruct, i)));
+        }
+        isGeneratingOutlinedTask = true;
+        emitRange(fields, task->getArg(1), task->getArg(2));
+        isGeneratingOutlinedTask = false;
+        ir.CreateRetVoid();
+        ir.restoreIP(savedIP);
+        return task;
+    }
+
+    // read every identifier that is not a domain variable once, before the parallel for
+    void LLVMGen::captureOutlinedIdentifiers(const std::vector<std::shared_ptr<AST>> &identifiers, const std::vector<std::shared_ptr<Symbol>> &domainSymbols,
+                                             std::vector<llvm::Value*> &captures, std::vector<std::shared_ptr<Symbol>> &capturedSymbols) {
+        for (auto identifier : identifiers) {
+            auto symbol = identifier->symbol;
+            if (std::find(domainSymbols.begin(), domainSymbols.end(), symbol) != domainSymbols.end()
+            || std::find(capturedSymbols.begin(), capturedSymbols.end(), symbol) != capturedSymbols.end()) {
+                continue;
+            }
+            captures.push_back(generateUnboxedScalar(identifier, getUnboxedScalarTypeId(identifier)));
+            capturedSymbols.push_back(symbol);
+        }
+    }
+
     void LLVMGen::visitFilter(std::shared_ptr<AST> t) {
 
         llvm::Function* parentFunc = ir.GetInsertBlock()->getParent();
@@ -1514,6 +1906,76 @@ namespace gazprea
         llvmFunction.call("variableInitFromDeclaration", {numFiltersIndexVar, indexVarType, constZero});
 
         auto acceptMatrix = llvmFunction.call("acceptMatrixMalloc", {ir.getInt64(numFilters), domainArrayLength_i64}); 
+
+        std::vector<std::shared_ptr<AST>> identifiers;
+        llvm::BasicBlock* filterDone = nullptr;
+        bool allPredicatesBoolean = true;
+        for (auto predicate : t->children[1]->children) {
+            allPredicatesBoolean = allPredicatesBoolean && getUnboxedScalarTypeId(predicate) == Type::BOOLEAN;
+        }
+        if (allPredicatesBoolean && isParallelComprehension(t->children[1]->children, identifiers)) {
+            auto domainSymbol = t->children[0]->symbol;
+            int domainTypeId;
+            auto domainData = getParallelDomainData(domainSymbol, domainArrayVar, identifiers, domainTypeId);
+            llvm::BasicBlock* parallel = llvm::BasicBlock::Create(globalCtx, "filterParallel", parentFunc);
+            llvm::BasicBlock* serial = llvm::BasicBlock::Create(globalCtx, "filterSerial", parentFunc);
+            filterDone = llvm::BasicBlock::Create(globalCtx, "filterDone", parentFunc);
+            if (domainData != nullptr) {
+                // fall back to the serial loops if the domain is not a vector of the expected type
+                ir.CreateCondBr(ir.CreateIsNotNull(domainData), parallel, serial);
+            } else {
+                ir.CreateBr(parallel);
+            }
+            ir.SetInsertPoint(parallel);
+
+            std::vector<llvm::Value*> captures = {acceptMatrix, domainData != nullptr ? domainData : acceptMatrix, domainArrayLength_i64};
+            std::vector<std::shared_ptr<Symbol>> capturedSymbols;
+            captureOutlinedIdentifiers(identifiers, {domainSymbol}, captures, capturedSymbols);
+            llvm::Value* taskArg;
+            // the accept matrix is bit packed with word aligned rows, so each task owns whole words of every row:
+            // it evaluates every predicate on the 64 domain variables of a word and stores the words once
+            auto rowWords = ir.CreateLShr(ir.CreateAdd(domainArrayLength_i64, ir.getInt64(63)), ir.getInt64(6));
+            auto task = createOutlinedTask("filterTask", captures, taskArg,
+            [&](const std::vector<llvm::Value*> &fields, llvm::Value* begin, llvm::Value* end) {
+                for (size_t i = 0; i < capturedSymbols.size(); i++) {
+                    unboxedSymbolValues[capturedSymbols[i]] = fields[3 + i];
+                }
+                llvm::Function* taskFunc = ir.GetInsertBlock()->getParent();
+                llvm::IRBuilder<> entryBuilder(&taskFunc->getEntryBlock(), taskFunc->getEntryBlock().begin());
+                std::vector<llvm::Value*> acceptWords;
+                for (size_t i = 0; i < numFilters; i++) {
+                    acceptWords.push_back(entryBuilder.CreateAlloca(ir.getInt64Ty()));
+                }
+                auto taskRowWords = ir.CreateLShr(ir.CreateAdd(fields[2], ir.getInt64(63)), ir.getInt64(6));
+                createNativeLoop(begin, end, [&](llvm::Value* word) {
+                    for (auto acceptWord : acceptWords) {
+                        ir.CreateStore(ir.getInt64(0), acceptWord);
+                    }
+                    auto wordBegin = ir.CreateShl(word, ir.getInt64(6));
+                    auto wordEnd = ir.CreateAdd(wordBegin, ir.getInt64(64));
+                    wordEnd = ir.CreateSelect(ir.CreateICmpSLT(wordEnd, fields[2]), wordEnd, fields[2]);
+                    createNativeLoop(wordBegin, wordEnd, [&](llvm::Value* index) {
+                        if (domainData != nullptr) {
+                            unboxedSymbolValues[domainSymbol] = loadUnboxedArrayElement(fields[1], index, domainTypeId);
+                        }
+                        auto bitPos = ir.CreateSub(index, wordBegin);
+                        for (size_t i = 0; i < numFilters; i++) {
+                            auto value = generateUnboxedScalar(t->children[1]->children[i]->children[0], Type::BOOLEAN);
+                            auto bit = ir.CreateShl(ir.CreateZExt(value, ir.getInt64Ty()), bitPos);
+                            ir.CreateStore(ir.CreateOr(ir.CreateLoad(ir.getInt64Ty(), acceptWords[i]), bit), acceptWords[i]);
+                        }
+                    });
+                    for (size_t i = 0; i < numFilters; i++) {
+                        auto position = ir.CreateAdd(ir.CreateMul(ir.getInt64(i), taskRowWords), word);
+                        ir.CreateStore(ir.CreateLoad(ir.getInt64Ty(), acceptWords[i]), ir.CreateInBoundsGEP(ir.getInt64Ty(), fields[0], position));
+                    }
+                });
+                unboxedSymbolValues.clear();
+            });
+            llvmFunction.call("threadPoolParallelFor", {ir.getInt64(0), rowWords, ir.getInt64(PARALLEL_COMPREHENSION_GRAIN / 64), task, taskArg});
+            ir.CreateBr(filterDone);
+            ir.SetInsertPoint(serial);
+        }
         
         for (size_t i = 0; i < numFilters; i++) {
             //create basic blocks
@@ -1549,12 +2011,10 @@ namespace gazprea
             visit(t->children[1]->children[i]);
             
             //get boolean value from ast
-            auto exprVar = llvmFunction.call("variableMalloc", {});
-            llvmFunction.call("variableInitFromMemcpy", {exprVar, t->children[1]->children[i]->llvmValue});
+            auto exprVar = moveOrCopyExpression(t->children[1]->children[i]);
             llvm::Value *boolValue = llvmFunction.call("variableGetBooleanValue", {exprVar});
             auto filterIdx = ir.getInt64(i);
             auto domainIdx = ir.CreateIntCast(llvmFunction.call("variableGetIntegerValue", {domainIndexVar}), ir.getInt64Ty(),false);
-            freeExpressionIfNecessary(t->children[1]->children[i]);
             llvmFunction.call("variableDestructThenFree", {exprVar});
 
             //set the accept matrix
@@ -1566,6 +2026,10 @@ namespace gazprea
             ir.CreateBr(header);    
             ir.SetInsertPoint(merge);
         }
+        if (filterDone != nullptr) {
+            ir.CreateBr(filterDone);
+            ir.SetInsertPoint(filterDone);
+        }
         auto resultTuple = llvmFunction.call("variableMalloc", {});
         llvmFunction.call("variableInitFromFilterArray", {resultTuple, ir.getInt64(numFilters), domainArrayVar, acceptMatrix}); 
         t->llvmValue = resultTuple;
@@ -1612,6 +2076,13 @@ namespace gazprea
     }
 
     void LLVMGen::visitBinaryOperation(std::shared_ptr<AST> t) {
+        int operandTypeId;
+        int resultTypeId = getUnboxedBinaryOperationTypeId(t, operandTypeId);
+        if (resultTypeId != -1) {
+            // both operands are known scalars, compute the whole subtree natively and box the result once
+            t->llvmValue = boxUnboxedScalar(generateUnboxedBinaryOperation(t), resultTypeId);
+            return;
+        }
         visitChildren(t);
         int opCode;
         switch (t->children[2]->getNodeType()) {
@@ -1687,6 +2158,11 @@ namespace gazprea
             t->llvmValue = runtimeVariableObject;
             return;
         }
+        int resultTypeId = getUnboxedUnaryOperationTypeId(t);
+        if (resultTypeId != -1) {
+            t->llvmValue = boxUnboxedScalar(generateUnboxedUnaryOperation(t), resultTypeId);
+            return;
+        }
         visitChildren(t);
         int opCode;
         switch (t->children[0]->getNodeType()) {
@@ -1708,7 +2184,386 @@ namespace gazprea
         freeExprAtomIfNecessary(t->children[1]);
     }
 
+    // returns the type id of a scalar expression that can be kept as a native LLVM value, -1 otherwise
+    int LLVMGen::getUnboxedScalarTypeId(std::shared_ptr<AST> t) {
+        if (t->evalType == nullptr) {
+            return -1;
+        }
+        switch (t->evalType->getTypeId()) {
+            case Type::INTEGER:
+            case Type::REAL:
+            case Type::BOOLEAN:
+            case Type::CHARACTER:
+                return t->evalType->getTypeId();
+            default:
+                return -1;
+        }
+    }
+
+    // returns the result type id if the binary operation can be computed natively, -1 otherwise
+    int LLVMGen::getUnboxedBinaryOperationTypeId(std::shared_ptr<AST> t, int &operandTypeId) {
+        int lhsTypeId = getUnboxedScalarTypeId(t->children[0]);
+        int rhsTypeId = getUnboxedScalarTypeId(t->children[1]);
+        if (lhsTypeId == -1 || rhsTypeId == -1 || getUnboxedScalarTypeId(t) == -1) {
+            return -1;
+        }
+        if (lhsTypeId == rhsTypeId) {
+            operandTypeId = lhsTypeId;
+        } else if ((lhsTypeId == Type::INTEGER && rhsTypeId == Type::REAL) 
+        || (lhsTypeId == Type::REAL && rhsTypeId == Type::INTEGER)) {
+            operandTypeId = Type::REAL;
+        } else {
+            return -1;
+        }
+        bool isNumeric = operandTypeId == Type::INTEGER || operandTypeId == Type::REAL;
+
+        int resultTypeId = -1;
+        switch (t->children[2]->getNodeType()) {
+            case GazpreaParser::CARET:
+                // integer exponentiation has its own rules in the runtime
+                if (operandTypeId == Type::REAL) {
+                    resultTypeId = Type::REAL;
+                }
+                break;
+            case GazpreaParser::ASTERISK:
+            case GazpreaParser::DIV:
+            case GazpreaParser::MODULO:
+            case GazpreaParser::PLUS:
+            case GazpreaParser::MINUS:
+                if (isNumeric) {
+                    resultTypeId = operandTypeId;
+                }
+                break;
+            case GazpreaParser::LESSTHAN:
+            case GazpreaParser::GREATERTHAN:
+            case GazpreaParser::LESSTHANOREQUAL:
+            case GazpreaParser::GREATERTHANOREQUAL:
+                if (isNumeric) {
+                    resultTypeId = Type::BOOLEAN;
+                }
+                break;
+            case GazpreaParser::ISEQUAL:
+            case GazpreaParser::ISNOTEQUAL:
+                // character equality is left to the runtime
+                if (isNumeric || operandTypeId == Type::BOOLEAN) {
+                    resultTypeId = Type::BOOLEAN;
+                }
+                break;
+            case GazpreaParser::AND:
+            case GazpreaParser::OR:
+            case GazpreaParser::XOR:
+                if (operandTypeId == Type::BOOLEAN) {
+                    resultTypeId = Type::BOOLEAN;
+                }
+                break;
+        }
+        if (resultTypeId != t->evalType->getTypeId()) {
+            return -1;
+        }
+        return resultTypeId;
+    }
+
+    // returns the result type id if the unary operation can be computed natively, -1 otherwise
+    int LLVMGen::getUnboxedUnaryOperationTypeId(std::shared_ptr<AST> t) {
+        int operandTypeId = getUnboxedScalarTypeId(t->children[1]);
+        switch (t->children[0]->getNodeType()) {
+            case GazpreaParser::PLUS:
+            case GazpreaParser::MINUS:
+                if (operandTypeId == Type::INTEGER || operandTypeId == Type::REAL) {
+                    return operandTypeId;
+                }
+                return -1;
+            default:
+                // "not" operator
+                if (operandTypeId == Type::BOOLEAN) {
+                    return operandTypeId;
+                }
+                return -1;
+        }
+    }
+
+    // evaluate a scalar expression to a native value (i32, float, i1 or i8) converted to typeId
+    llvm::Value* LLVMGen::generateUnboxedScalar(std::shared_ptr<AST> t, int typeId) {
+        int srcTypeId = getUnboxedScalarTypeId(t);
+        int operandTypeId;
+        llvm::Value* value;
+        if (t->getNodeType() == GazpreaParser::IntegerConstant) {
+            value = ir.getInt32(parseIntegerLiteral(t));
+        } else if (t->getNodeType() == GazpreaParser::REAL_CONSTANT_TOKEN) {
+            value = llvm::ConstantFP::get(ir.getFloatTy(), parseRealLiteral(t));
+        } else if (t->getNodeType() == GazpreaParser::BooleanConstant) {
+            value = ir.getInt1(t->parseTree->getText() == "true");
+        } else if (t->getNodeType() == GazpreaParser::IDENTIFIER_TOKEN && unboxedSymbolValues.count(t->symbol) != 0) {
+            value = unboxedSymbolValues[t->symbol];
+        } else if (t->getNodeType() == GazpreaParser::BINARY_OP_TOKEN && getUnboxedBinaryOperationTypeId(t, operandTypeId) != -1) {
+            value = generateUnboxedBinaryOperation(t);
+        } else if (t->getNodeType() == GazpreaParser::UNARY_TOKEN && getUnboxedUnaryOperationTypeId(t) != -1) {
+            value = generateUnboxedUnaryOperation(t);
+        } else if (t->getNodeType() == GazpreaParser::CALL_PROCEDURE_FUNCTION_IN_EXPRESSION && isGeneratingOutlinedTask) {
+            value = generateUnboxedCall(t);
+        } else {
+            // identifiers, calls, indexing etc. are still produced by the runtime, only their value is read here
+            visit(t);
+            value = unboxScalarVariable(t->llvmValue, srcTypeId);
+            freeExprAtomIfNecessary(t);
+        }
+        if (srcTypeId == Type::INTEGER && typeId == Type::REAL) {
+            value = ir.CreateSIToFP(value, ir.getFloatTy());
+        }
+        return value;
+    }
+
+    llvm::Value* LLVMGen::generateUnboxedBinaryOperation(std::shared_ptr<AST> t) {
+        int operandTypeId;
+        getUnboxedBinaryOperationTypeId(t, operandTypeId);
+        auto lhs = generateUnboxedScalar(t->children[0], operandTypeId);
+        auto rhs = generateUnboxedScalar(t->children[1], operandTypeId);
+        bool isReal = operandTypeId == Type::REAL;
+
+        switch (t->children[2]->getNodeType()) {
+            case GazpreaParser::CARET:
+                return ir.CreateBinaryIntrinsic(llvm::Intrinsic::pow, lhs, rhs);
+            case GazpreaParser::ASTERISK:
+                return isReal ? ir.CreateFMul(lhs, rhs) : ir.CreateMul(lhs, rhs);
+            case GazpreaParser::DIV:
+                if (isReal) {
+                    return ir.CreateFDiv(lhs, rhs);
+                }
+                createDivisionByZeroCheck(rhs, "Attempt to divide by zero!");
+                return ir.CreateSDiv(lhs, rhs);
+            case GazpreaParser::MODULO:
+                if (isReal) {
+                    return ir.CreateFRem(lhs, rhs);
+                }
+                createDivisionByZeroCheck(rhs, "Attempt to mod by zero!");
+                // widen so that INT_MIN % -1 does not trap, same as the runtime
+                return ir.CreateTrunc(
+                    ir.CreateSRem(ir.CreateSExt(lhs, ir.getInt64Ty()), ir.CreateSExt(rhs, ir.getInt64Ty())), 
+                    ir.getInt32Ty()
+                );
+            case GazpreaParser::PLUS:
+                return isReal ? ir.CreateFAdd(lhs, rhs) : ir.CreateAdd(lhs, rhs);
+            case GazpreaParser::MINUS:
+                return isReal ? ir.CreateFSub(lhs, rhs) : ir.CreateSub(lhs, rhs);
+            case GazpreaParser::LESSTHAN:
+                return isReal ? ir.CreateFCmpOLT(lhs, rhs) : ir.CreateICmpSLT(lhs, rhs);
+            case GazpreaParser::GREATERTHAN:
+                return isReal ? ir.CreateFCmpOGT(lhs, rhs) : ir.CreateICmpSGT(lhs, rhs);
+            case GazpreaParser::LESSTHANOREQUAL:
+                return isReal ? ir.CreateFCmpOLE(lhs, rhs) : ir.CreateICmpSLE(lhs, rhs);
+            case GazpreaParser::GREATERTHANOREQUAL:
+                return isReal ? ir.CreateFCmpOGE(lhs, rhs) : ir.CreateICmpSGE(lhs, rhs);
+            case GazpreaParser::ISEQUAL:
+                return isReal ? ir.CreateFCmpOEQ(lhs, rhs) : ir.CreateICmpEQ(lhs, rhs);
+            case GazpreaParser::ISNOTEQUAL:
+                return isReal ? ir.CreateFCmpUNE(lhs, rhs) : ir.CreateICmpNE(lhs, rhs);
+            case GazpreaParser::AND:
+                return ir.CreateAnd(lhs, rhs);
+            case GazpreaParser::OR:
+                return ir.CreateOr(lhs, rhs);
+            default:
+                // "xor" operator
+                return ir.CreateXor(lhs, rhs);
+        }
+    }
+
+    llvm::Value* LLVMGen::generateUnboxedUnaryOperation(std::shared_ptr<AST> t) {
+        int typeId = getUnboxedUnaryOperationTypeId(t);
+        if (t->children[0]->getNodeType() == GazpreaParser::MINUS
+        && t->children[1]->getNodeType() == GazpreaParser::IntegerConstant
+        && t->children[1]->parseTree->getText() == "2147483648") {
+            // Handle the edge case: -2147483648
+            return ir.getInt32(-2147483648);
+        }
+        auto operand = generateUnboxedScalar(t->children[1], typeId);
+        switch (t->children[0]->getNodeType()) {
+            case GazpreaParser::PLUS:
+                return operand;
+            case GazpreaParser::MINUS:
+                return typeId == Type::REAL ? ir.CreateFNeg(operand) : ir.CreateNeg(operand);
+            default:
+                // "not" operator
+                return ir.CreateNot(operand);
+        }
+    }
+
+    // store a native scalar value into a new runtime variable so it can be passed to the runtime
+    llvm::Value* LLVMGen::boxUnboxedScalar(llvm::Value* value, int typeId) {
+        auto runtimeVariableObject = llvmFunction.call("variableMalloc", {});
+        switch (typeId) {
+            case Type::INTEGER:
+                llvmFunction.call("variableInitFromIntegerScalar", {runtimeVariableObject, value});
+                break;
+            case Type::REAL:
+                llvmFunction.call("variableInitFromRealScalar", {runtimeVariableObject, value});
+                break;
+            case Type::BOOLEAN:
+                llvmFunction.call("variableInitFromBooleanScalar", {runtimeVariableObject, ir.CreateZExt(value, ir.getInt32Ty())});
+                break;
+            default:
+                llvmFunction.call("variableInitFromCharacterScalar", {runtimeVariableObject, value});
+                break;
+        }
+        return runtimeVariableObject;
+    }
+
+    // read the native value of a scalar runtime variable of type typeId
+    llvm::Value* LLVMGen::unboxScalarVariable(llvm::Value* variable, int typeId) {
+        switch (typeId) {
+            case Type::INTEGER:
+                return llvmFunction.call("variableGetIntegerScalarValue", { variable });
+            case Type::REAL:
+                return llvmFunction.call("variableGetRealScalarValue", { variable });
+            case Type::BOOLEAN:
+                return ir.CreateICmpNE(llvmFunction.call("variableGetBooleanScalarValue", { variable }), ir.getInt32(0));
+            default:
+                return llvmFunction.call("variableGetCharacterScalarValue", { variable });
+        }
+    }
+
+    // call a function from an outlined task, where the arguments only exist as native values: each one is boxed into
+    // a fresh variable, which the callee copies into its parameter, and the boxed result is unboxed and freed
+    llvm::Value* LLVMGen::generateUnboxedCall(std::shared_ptr<AST> t) {
+        auto subroutineSymbol = std::dynamic_pointer_cast<SubroutineSymbol>(t->children[0]->symbol);
+        std::vector<llvm::Value *> arguments;
+        for (auto expressionAST : t->children[1]->children) {
+            int argumentTypeId = getUnboxedScalarTypeId(expressionAST->children[0]);
+            arguments.push_back(boxUnboxedScalar(generateUnboxedScalar(expressionAST->children[0], argumentTypeId), argumentTypeId));
+        }
+        auto returnValue = ir.CreateCall(subroutineSymbol->llvmFunction, arguments);
+        for (auto argument : arguments) {
+            llvmFunction.call("variableDestructThenFree", { argument });
+        }
+        auto value = unboxScalarVariable(returnValue, getUnboxedScalarTypeId(t));
+        llvmFunction.call("variableDestructThenFree", { returnValue });
+        return value;
+    }
+
+    // the runtime ElementTypeID of a scalar type id
+    int LLVMGen::getRuntimeElementTypeId(int typeId) {
+        switch (typeId) {
+            case Type::INTEGER:
+                return 0;
+            case Type::REAL:
+                return 1;
+            case Type::BOOLEAN:
+                return 2;
+            default:
+                return 3;
+        }
+    }
+
+    // the native type the runtime uses to store one element of a scalar type (booleans are stored as i32)
+    llvm::Type* LLVMGen::getUnboxedElementStorageType(int typeId) {
+        switch (typeId) {
+            case Type::INTEGER:
+            case Type::BOOLEAN:
+                return ir.getInt32Ty();
+            case Type::REAL:
+                return ir.getFloatTy();
+            default:
+                return ir.getInt8Ty();
+        }
+    }
+
+    bool LLVMGen::isBuiltInCall(std::shared_ptr<AST> t, const std::string &name) {
+        if (t->getNodeType() != GazpreaParser::CALL_PROCEDURE_FUNCTION_IN_EXPRESSION) {
+            return false;
+        }
+        auto subroutineSymbol = std::dynamic_pointer_cast<SubroutineSymbol>(t->children[0]->symbol);
+        return subroutineSymbol != nullptr && subroutineSymbol->isBuiltIn && subroutineSymbol->name == name
+        && t->children[1]->children.size() == 1;
+    }
+
+    // true for an integer interval, <integer interval> by <step> and reverse() of either; these are the arithmetic
+    // sequences head, head + step, ... that iterator loops, length() and indexing with a scalar read without storing
+    // them, any other use of the sequence (e.g. assigning or printing it) still goes through the runtime as a vector
+    bool LLVMGen::isLazyIntegerSequence(std::shared_ptr<AST> t) {
+        if (isBuiltInCall(t, "gazprea.subroutine.reverse")) {
+            return isLazyIntegerSequence(t->children[1]->children[0]->children[0]);
+        }
+        if (t->getNodeType() == GazpreaParser::BINARY_OP_TOKEN && t->children[2]->getNodeType() == GazpreaParser::BY) {
+            auto intervalType = t->children[0]->evalType;
+            return intervalType != nullptr && intervalType->getTypeId() == Type::INTEGER_INTERVAL;
+        }
+        return t->evalType != nullptr && t->evalType->getTypeId() == Type::INTEGER_INTERVAL;
+    }
+
+    // evaluates only the interval and the step of a sequence accepted by isLazyIntegerSequence; length is an i64,
+    // head and step are i32 and element i (from 0) is head + i * step
+    void LLVMGen::generateLazyIntegerSequence(std::shared_ptr<AST> t, llvm::Value* &head, llvm::Value* &step, llvm::Value* &length) {
+        if (isBuiltInCall(t, "gazprea.subroutine.reverse")) {
+            // starts from the last element and walks back, the offset wraps like the loop counter does
+            generateLazyIntegerSequence(t->children[1]->children[0]->children[0], head, step, length);
+            auto lastOffset = ir.CreateMul(ir.CreateTrunc(ir.CreateSub(length, ir.getInt64(1)), ir.getInt32Ty()), step);
+            head = ir.CreateAdd(head, lastOffset);
+            step = ir.CreateNeg(step);
+        } else if (t->getNodeType() == GazpreaParser::BINARY_OP_TOKEN && t->children[2]->getNodeType() == GazpreaParser::BY) {
+            // the by operation itself is not generated
+            visit(t->children[0]);
+            visit(t->children[1]);
+            auto interval = t->children[0]->llvmValue;
+            auto stepValue = t->children[1]->llvmValue;
+            length = llvmFunction.call("variableGetIntervalStepLength", {interval, stepValue});
+            head = llvmFunction.call("variableGetIntegerIntervalHead", {interval});
+            step = llvmFunction.call("variableGetIntervalStepValue", {stepValue});
+            freeExprAtomIfNecessary(t->children[0]);
+            freeExprAtomIfNecessary(t->children[1]);
+        } else {
+            visit(t);
+            length = llvmFunction.call("variableGetLength", {t->llvmValue});
+            head = llvmFunction.call("variableGetIntegerIntervalHead", {t->llvmValue});
+            step = ir.getInt32(1);
+            freeExprAtomIfNecessary(t);
+        }
+    }
+
+    // allocas outside the entry block would grow the stack on every execution, e.g. for a loop nested in another loop
+    llvm::AllocaInst* LLVMGen::createEntryBlockAlloca(llvm::Type* type) {
+        llvm::Function* parentFunc = ir.GetInsertBlock()->getParent();
+        llvm::IRBuilder<> entryBuilder(&parentFunc->getEntryBlock(), parentFunc->getEntryBlock().begin());
+        return entryBuilder.CreateAlloca(type);
+    }
+
+    // load the m_data pointer of a concrete array variable as a pointer to its native element type
+    llvm::Value* LLVMGen::getUnboxedArrayData(llvm::Value* arrayVariable, int typeId) {
+        auto dataField = ir.CreateStructGEP(runtimeVariableTy, arrayVariable, 1);
+        auto data = ir.CreateLoad(ir.getInt8PtrTy(), dataField);
+        return ir.CreateBitCast(data, getUnboxedElementStorageType(typeId)->getPointerTo());
+    }
+
+    void LLVMGen::storeUnboxedArrayElement(llvm::Value* arrayData, llvm::Value* index, llvm::Value* value, int typeId) {
+        llvm::Type* storageType = getUnboxedElementStorageType(typeId);
+        if (typeId == Type::BOOLEAN) {
+            value = ir.CreateZExt(value, storageType);
+        }
+        ir.CreateStore(value, ir.CreateInBoundsGEP(storageType, arrayData, index));
+    }
+
+    void LLVMGen::createDivisionByZeroCheck(llvm::Value* divisor, const std::string& errorMsg) {
+        llvm::Function* parentFunc = ir.GetInsertBlock()->getParent();
+        llvm::BasicBlock* errorBB = llvm::BasicBlock::Create(globalCtx, "DivisionByZero", parentFunc);
+        llvm::BasicBlock* continueBB = llvm::BasicBlock::Create(globalCtx, "DivisionByZeroCheckMerge", parentFunc);
+        ir.CreateCondBr(ir.CreateICmpEQ(divisor, ir.getInt32(0)), errorBB, continueBB);
+        ir.SetInsertPoint(errorBB);
+        llvmFunction.call("errorAndExit", { ir.CreateGlobalStringPtr(errorMsg) });
+        ir.CreateUnreachable();
+        ir.SetInsertPoint(continueBB);
+    }
+
     void LLVMGen::visitIndexing(std::shared_ptr<AST> t) {
+        auto indices = t->children[1]->children;
+        if (indices.size() == 1 && isLazyIntegerSequence(t->children[0])
+        && indices[0]->evalType != nullptr && indices[0]->evalType->getTypeId() == Type::INTEGER) {
+            // one element of an integer sequence, computed without storing the sequence
+            llvm::Value *head, *step, *length;
+            generateLazyIntegerSequence(t->children[0], head, step, length);
+            visit(indices[0]);
+            t->llvmValue = llvmFunction.call("variableMalloc", {});
+            llvmFunction.call("variableInitFromIntegerSequenceIndexing", {t->llvmValue, head, step, length, indices[0]->llvmValue});
+            freeExpressionIfNecessary(indices[0]);
+            return;
+        }
         visitChildren(t);
         auto runtimeVariableObject = llvmFunction.call("variableMalloc", {});
         auto numRHSExpressions = t->children[1]->children.size();
@@ -1760,6 +2615,14 @@ namespace gazprea
     }
 
     void LLVMGen::visitCallSubroutineInExpression(std::shared_ptr<AST> t) {
+        if (isBuiltInCall(t, "gazprea.subroutine.length") && isLazyIntegerSequence(t->children[1]->children[0]->children[0])) {
+            // the length of an integer sequence follows from its bounds and step
+            llvm::Value *head, *step, *length;
+            generateLazyIntegerSequence(t->children[1]->children[0]->children[0], head, step, length);
+            t->llvmValue = llvmFunction.call("variableMalloc", {});
+            llvmFunction.call("variableInitFromIntegerScalar", {t->llvmValue, ir.CreateTrunc(length, ir.getInt32Ty())});
+            return;
+        }
         visitChildren(t);
         auto subroutineSymbol = std::dynamic_pointer_cast<SubroutineSymbol>(t->children[0]->symbol);
         auto *ctx = dynamic_cast<GazpreaParser::CallProcedureFunctionInExpressionContext*>(t->parseTree);
@@ -2399,12 +3262,37 @@ namespace gazprea
     }
 
     void LLVMGen::freeExpressionIfNecessary(std::shared_ptr<AST> t) {
-        if (t->children[0]->getNodeType() != GazpreaParser::IDENTIFIER_TOKEN
-        && t->children[0]->getNodeType() != GazpreaParser::TUPLE_ACCESS_TOKEN) {
+        if (isTemporaryExpression(t)) {
             llvmFunction.call("variableDestructThenFree", t->llvmValue);
         }
     }
 
+    // true if the value of the expression is a temporary owned by the expression, i.e. it is not a named variable
+    bool LLVMGen::isTemporaryExpression(std::shared_ptr<AST> t) {
+        return t->children[0]->getNodeType() != GazpreaParser::IDENTIFIER_TOKEN
+        && t->children[0]->getNodeType() != GazpreaParser::TUPLE_ACCESS_TOKEN;
+    }
+
+    // variableInitFromDeclaration followed by freeExpressionIfNecessary, a temporary hands its buffers to the variable
+    void LLVMGen::initializeFromDeclarationThenFreeExpression(llvm::Value* variable, llvm::Value* type, std::shared_ptr<AST> t) {
+        if (isTemporaryExpression(t)) {
+            llvmFunction.call("variableInitFromDeclarationMove", {variable, type, t->llvmValue});
+        } else {
+            llvmFunction.call("variableInitFromDeclaration", {variable, type, t->llvmValue});
+        }
+    }
+
+    // a new variable with the value of the expression, the expression must not be freed afterwards
+    llvm::Value* LLVMGen::moveOrCopyExpression(std::shared_ptr<AST> t) {
+        auto variable = llvmFunction.call("variableMalloc", {});
+        if (isTemporaryExpression(t)) {
+            llvmFunction.call("variableInitFromMove", {variable, t->llvmValue});
+        } else {
+            llvmFunction.call("variableInitFromMemcpy", {variable, t->llvmValue});
+        }
+        return variable;
+    }
+
     void LLVMGen::freeExprAtomIfNecessary(std::shared_ptr<AST> t) {
         if (t->getNodeType() != GazpreaParser::IDENTIFIER_TOKEN
         && t->getNodeType() != GazpreaParser::TUPLE_ACCESS_TOKEN) {
@@ -2455,17 +3343,269 @@ namespace gazprea
     }
 
     void LLVMGen::Print() {
-        // write module as .ll file
-        std::string compiledLLFile;
-        llvm::raw_string_ostream out(compiledLLFile);
-
         llvm::raw_os_ostream llOut(std::cout);
         llvm::raw_os_ostream llErr(std::cerr);
-        llvm::verifyModule(mod, &llErr);
+        bool isBroken = llvm::verifyModule(mod, &llErr);
+        llErr.flush();
 
-        mod.print(out, nullptr);
-        out.flush();
-        std::ofstream outFile(outfile);
-        outFile << compiledLLFile;
+        // the target machine is only needed for native output, or to give the optimizer a data layout
+        std::unique_ptr<llvm::TargetMachine> targetMachine;
+        if (!isBroken && (options.emitKind != EmitKind::LLVM_IR || options.optLevel > 0 || options.linkRuntimeBitcode)) {
+            targetMachine = createTargetMachine();
+        }
+        if (!isBroken && options.linkRuntimeBitcode && !linkRuntimeBitcode()) {
+            std::exit(1);
+        }
+        if (!isBroken) {
+            optimizeModule();
+        }
+
+        if (options.runJIT) {
+            if (isBroken) {
+                std::cerr << "Unable to run a broken module\n";
+                std::exit(1);
+            }
+            std::exit(runWithJIT());
+        }
+
+        if (options.emitKind == EmitKind::LLVM_IR) {
+            // write module as .ll file
+            std::string compiledLLFile;
+            llvm::raw_string_ostream out(compiledLLFile);
+            mod.print(out, nullptr);
+            out.flush();
+            std::ofstream outFile(outfile);
+            outFile << compiledLLFile;
+            return;
+        }
+
+        if (isBroken || (options.emitKind != EmitKind::BITCODE && targetMachine == nullptr)) {
+            std::cerr << "Unable to write " << outfile << "\n";
+            std::exit(1);
+        }
+        bool success = true;
+        switch (options.emitKind) {
+            case EmitKind::BITCODE: {
+                std::error_code errorCode;
+                llvm::raw_fd_ostream dest(outfile, errorCode, llvm::sys::fs::OF_None);
+                if (errorCode) {
+                    std::cerr << "Could not open file " << outfile << ": " << errorCode.message() << "\n";
+                    success = false;
+                    break;
+                }
+                llvm::WriteBitcodeToFile(mod, dest);
+                break;
+            }
+            case EmitKind::ASSEMBLY:
+                success = emitNativeFile(targetMachine.get(), outfile, llvm::CGFT_AssemblyFile);
+                break;
+            case EmitKind::OBJECT:
+                success = emitNativeFile(targetMachine.get(), outfile, llvm::CGFT_ObjectFile);
+                break;
+            case EmitKind::EXECUTABLE: {
+                std::string objectFile = outfile + ".o";
+                success = emitNativeFile(targetMachine.get(), objectFile, llvm::CGFT_ObjectFile) && linkExecutable(objectFile);
+                llvm::sys::fs::remove(objectFile);
+                break;
+            }
+            default:
+                break;
+        }
+        if (!success) {
+            std::exit(1);
+        }
+    }
+
+    // link the runtime functions the module uses from gazrt.bc, internalized so they can be inlined and specialized
+    bool LLVMGen::linkRuntimeBitcode() {
+        auto buffer = llvm::MemoryBuffer::getFile(options.runtimeBitcodePath);
+        if (!buffer) {
+            std::cerr << "Unable to read the runtime bitcode " << options.runtimeBitcodePath << ": "
+                      << buffer.getError().message() << ", use --gazrt-bc=<path to gazrt.bc>\n";
+            return false;
+        }
+        auto runtime = llvm::parseBitcodeFile((*buffer)->getMemBufferRef(), globalCtx);
+        if (!runtime) {
+            std::cerr << "Unable to parse the runtime bitcode: " << llvm::toString(runtime.takeError()) << "\n";
+            return false;
+        }
+        // the runtime is compiled for the host, so only the spelling of the triple may differ
+        if (!mod.getTargetTriple().empty()) {
+            (*runtime)->setTargetTriple(mod.getTargetTriple());
+            (*runtime)->setDataLayout(mod.getDataLayout());
+        }
+
+        bool failed = llvm::Linker::linkModules(
+            mod, std::move(*runtime), llvm::Linker::Flags::LinkOnlyNeeded,
+            [](llvm::Module &linked, const llvm::StringSet<> &runtimeSymbols) {
+                llvm::internalizeModule(linked, [&runtimeSymbols](const llvm::GlobalValue &gv) {
+                    return !gv.hasName() || runtimeSymbols.count(gv.getName()) == 0;
+                });
+            });
+        if (failed || llvm::verifyModule(mod, &llvm::errs())) {
+            std::cerr << "Unable to link the runtime bitcode " << options.runtimeBitcodePath << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    // run the standard -O1/-O2/-O3 pipeline (mem2reg, instcombine, GVN, LICM, inlining, unrolling, vectorization) on the module
+    void LLVMGen::optimizeModule() {
+        if (options.optLevel == 0) {
+            return;
+        }
+        llvm::PassManagerBuilder passManagerBuilder;
+        passManagerBuilder.OptLevel = options.optLevel;
+        passManagerBuilder.SizeLevel = 0;
+        passManagerBuilder.Inliner = llvm::createFunctionInliningPass(options.optLevel, 0, false);
+        passManagerBuilder.LoopVectorize = options.optLevel > 1;
+        passManagerBuilder.SLPVectorize = options.optLevel > 1;
+
+        llvm::legacy::FunctionPassManager functionPassManager(&mod);
+        llvm::legacy::PassManager modulePassManager;
+        passManagerBuilder.populateFunctionPassManager(functionPassManager);
+        passManagerBuilder.populateModulePassManager(modulePassManager);
+
+        functionPassManager.doInitialization();
+        for (auto &function : mod) {
+            functionPassManager.run(function);
+        }
+        functionPassManager.doFinalization();
+        modulePassManager.run(mod);
+    }
+
+    // create a target machine for the host and set the module's triple and data layout to match it
+    std::unique_ptr<llvm::TargetMachine> LLVMGen::createTargetMachine() {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+
+        std::string targetTriple = llvm::sys::getDefaultTargetTriple();
+        std::string error;
+        auto target = llvm::TargetRegistry::lookupTarget(targetTriple, error);
+        if (target == nullptr) {
+            std::cerr << error << "\n";
+            return nullptr;
+        }
+
+        llvm::SubtargetFeatures features;
+        llvm::StringMap<bool> hostFeatures;
+        if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+            for (auto &feature : hostFeatures) {
+                features.AddFeature(feature.first(), feature.second);
+            }
+        }
+
+        llvm::CodeGenOpt::Level codeGenOptLevel;
+        switch (options.optLevel) {
+            case 0:
+                codeGenOptLevel = llvm::CodeGenOpt::None;
+                break;
+            case 1:
+                codeGenOptLevel = llvm::CodeGenOpt::Less;
+                break;
+            case 2:
+                codeGenOptLevel = llvm::CodeGenOpt::Default;
+                break;
+            default:
+                codeGenOptLevel = llvm::CodeGenOpt::Aggressive;
+                break;
+        }
+
+        llvm::TargetOptions targetOptions;
+        std::unique_ptr<llvm::TargetMachine> targetMachine(target->createTargetMachine(
+            targetTriple, llvm::sys::getHostCPUName(), features.getString(), targetOptions, 
+            llvm::Reloc::PIC_, llvm::None, codeGenOptLevel
+        ));
+        if (targetMachine == nullptr) {
+            std::cerr << "Unable to create a target machine for " << targetTriple << "\n";
+            return nullptr;
+        }
+        mod.setTargetTriple(targetTriple);
+        mod.setDataLayout(targetMachine->createDataLayout());
+        return targetMachine;
+    }
+
+    // write the module as a native assembly or object file
+    bool LLVMGen::emitNativeFile(llvm::TargetMachine *targetMachine, const std::string &path, llvm::CodeGenFileType fileType) {
+        std::error_code errorCode;
+        llvm::raw_fd_ostream dest(path, errorCode, llvm::sys::fs::OF_None);
+        if (errorCode) {
+            std::cerr << "Could not open file " << path << ": " << errorCode.message() << "\n";
+            return false;
+        }
+        llvm::legacy::PassManager passManager;
+        if (targetMachine->addPassesToEmitFile(passManager, dest, nullptr, fileType)) {
+            std::cerr << "The target machine cannot emit a file of this type\n";
+            return false;
+        }
+        passManager.run(mod);
+        dest.flush();
+        return true;
+    }
+
+    // link the object file against the static runtime with the system C compiler driver
+    bool LLVMGen::linkExecutable(const std::string &objectFile) {
+        if (options.runtimeLibraryPath.empty()) {
+            std::cerr << "No static gazrt library to link against, use --gazrt=<path to libgazrt.a>\n";
+            return false;
+        }
+        auto linker = llvm::sys::findProgramByName("cc");
+        if (!linker) {
+            std::cerr << "Unable to find the system linker driver cc\n";
+            return false;
+        }
+        std::vector<llvm::StringRef> args = { *linker, objectFile, options.runtimeLibraryPath, "-lm", "-lpthread", "-o", outfile };
+        std::string errorMsg;
+        int result = llvm::sys::ExecuteAndWait(*linker, args, llvm::None, {}, 0, 0, &errorMsg);
+        if (result != 0) {
+            std::cerr << "Linking " << outfile << " failed" << (errorMsg.empty() ? "" : ": " + errorMsg) << "\n";
+            return false;
+        }
+        return true;
+    }
+
+    // compile the module with an ORC LLJIT and call main in this process, with gazrt loaded from the shared library
+    int LLVMGen::runWithJIT() {
+        std::string errorMsg;
+        if (options.runtimeSharedLibraryPath.empty() ||
+            llvm::sys::DynamicLibrary::LoadLibraryPermanently(options.runtimeSharedLibraryPath.c_str(), &errorMsg)) {
+            std::cerr << "Unable to load the shared gazrt library, use --gazrt-shared=<path to libgazrt.so>"
+                      << (errorMsg.empty() ? "" : ": " + errorMsg) << "\n";
+            return 1;
+        }
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+
+        auto jit = llvm::orc::LLJITBuilder().create();
+        if (!jit) {
+            std::cerr << "Unable to create the JIT: " << llvm::toString(jit.takeError()) << "\n";
+            return 1;
+        }
+        auto processSymbols = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            (*jit)->getDataLayout().getGlobalPrefix());
+        if (!processSymbols) {
+            std::cerr << "Unable to resolve gazrt symbols: " << llvm::toString(processSymbols.takeError()) << "\n";
+            return 1;
+        }
+        (*jit)->getMainJITDylib().addGenerator(std::move(*processSymbols));
+        // the JIT takes ownership of the module, which shares the context with it
+        if (auto error = (*jit)->addIRModule(llvm::orc::ThreadSafeModule(std::move(ownedMod), threadSafeCtx))) {
+            std::cerr << "Unable to add the module to the JIT: " << llvm::toString(std::move(error)) << "\n";
+            return 1;
+        }
+        auto mainSymbol = (*jit)->lookup("main");
+        if (!mainSymbol) {
+            std::cerr << "Unable to compile main: " << llvm::toString(mainSymbol.takeError()) << "\n";
+            return 1;
+        }
+#if LLVM_VERSION_MAJOR >= 15
+        auto mainFunction = mainSymbol->toPtr<int (*)()>();
+#else
+        auto mainFunction = reinterpret_cast<int (*)()>(mainSymbol->getAddress());
+#endif
+        int result = mainFunction();
+        std::cout.flush();
+        std::fflush(stdout);
+        return result;
     }
-} // namespace gazprea
\ No newline at end of file
+} // namespace gazprea
@@ -102,11 +102,21 @@ void LLVMIRFunction::declareAllFunctions() {
         "variableInitFromDeclaration"
     );
 
+    declareFunction(
+        llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), runtimeTypeTy->getPointerTo(), runtimeVariableTy->getPointerTo() }, false),
+        "variableInitFromDeclarationMove"
+    );
+
     declareFunction(
         llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), runtimeVariableTy->getPointerTo() }, false),
         "variableAssignment"
     );
 
+    declareFunction(
+        llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), runtimeVariableTy->getPointerTo() }, false),
+        "variableAssignmentMove"
+    );
+
     declareFunction(
             llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), runtimeVariableTy->getPointerTo() }, false),
             "variableReplace"
@@ -121,6 +131,30 @@ void LLVMIRFunction::declareAllFunctions() {
         llvm::FunctionType::get(int32Ty, { runtimeVariableTy->getPointerTo() }, false),
         "variableGetBooleanValue"
     );
+    declareFunction(
+        llvm::FunctionType::get(int32Ty, { runtimeVariableTy->getPointerTo() }, false),
+        "variableGetIntegerScalarValue"
+    );
+    declareFunction(
+        llvm::FunctionType::get(int8Ty->getPointerTo(), { runtimeVariableTy->getPointerTo(), int32Ty }, false),
+        "variableGetConcreteVectorData"
+    );
+    declareFunction(
+        llvm::FunctionType::get(floatTy, { runtimeVariableTy->getPointerTo() }, false),
+        "variableGetRealScalarValue"
+    );
+    declareFunction(
+        llvm::FunctionType::get(int32Ty, { runtimeVariableTy->getPointerTo() }, false),
+        "variableGetBooleanScalarValue"
+    );
+    declareFunction(
+        llvm::FunctionType::get(int8Ty, { runtimeVariableTy->getPointerTo() }, false),
+        "variableGetCharacterScalarValue"
+    );
+    declareFunction(
+        llvm::FunctionType::get(voidTy, { int8Ty->getPointerTo() }, false),
+        "errorAndExit"
+    );
 
     // TypeInit
     declareFunction(
@@ -173,6 +207,10 @@ void LLVMIRFunction::declareAllFunctions() {
         llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), runtimeVariableTy->getPointerTo() }, false),
         "variableInitFromMemcpy"
     );
+    declareFunction(
+        llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), runtimeVariableTy->getPointerTo() }, false),
+        "variableInitFromMove"
+    );
     // Free
     declareFunction(
         llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo() }, false),
@@ -250,6 +288,14 @@ void LLVMIRFunction::declareAllFunctions() {
         llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), int64Ty, runtimeVariableTy->getPointerTo()->getPointerTo() }, false),
         "variableInitFromVectorLiteral"
     );
+    declareFunction(
+        llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), int32Ty, int64Ty }, false),
+        "variableInitFromTypedGeneratorVector"
+    );
+    declareFunction(
+        llvm::FunctionType::get(voidTy, { runtimeVariableTy->getPointerTo(), int32Ty, int64Ty, int64Ty }, false),
+        "variableInitFromTypedGeneratorMatrix"
+    );
     
     declareFunction(
         llvm::FunctionType::get(runtimeTypeTy->getPointerTo(), { runtimeVariableTy->getPointerTo(), runtimeTypeTy->getPointerTo() }, false),
@@ -280,6 +326,26 @@ void LLVMIRFunction::declareAllFunctions() {
         "variableGetLength"
     );
 
+    declareFunction(
+        llvm::FunctionType::get(int32Ty, {runtimeVariableTy->getPointerTo()}, false),
+        "variableGetIntegerIntervalHead"
+    );
+
+    declareFunction(
+        llvm::FunctionType::get(int64Ty, {runtimeVariableTy->getPointerTo(), runtimeVariableTy->getPointerTo()}, false),
+        "variableGetIntervalStepLength"
+    );
+
+    declareFunction(
+        llvm::FunctionType::get(int32Ty, {runtimeVariableTy->getPointerTo()}, false),
+        "variableGetIntervalStepValue"
+    );
+
+    declareFunction(
+        llvm::FunctionType::get(voidTy, {runtimeVariableTy->getPointerTo(), int32Ty, int32Ty, int64Ty, runtimeVariableTy->getPointerTo()}, false),
+        "variableInitFromIntegerSequenceIndexing"
+    );
+
     declareFunction(
             llvm::FunctionType::get(voidTy, {runtimeVariableTy->getPointerTo(), runtimeVariableTy->getPointerTo(), int64Ty}, false),
             "variableInitFromArrayElementAtIndex"
@@ -292,22 +358,29 @@ void LLVMIRFunction::declareAllFunctions() {
     
     // Filter functions
     declareFunction(
-        llvm::FunctionType::get(voidTy, {runtimeVariableTy->getPointerTo(), int64Ty, runtimeVariableTy->getPointerTo(), int32Ty->getPointerTo()}, false),
+        llvm::FunctionType::get(voidTy, {runtimeVariableTy->getPointerTo(), int64Ty, runtimeVariableTy->getPointerTo(), int64Ty->getPointerTo()}, false),
         "variableInitFromFilterArray"
     );
     declareFunction(
-        llvm::FunctionType::get(int32Ty->getPointerTo(), {int64Ty, int64Ty}, false),
+        llvm::FunctionType::get(int64Ty->getPointerTo(), {int64Ty, int64Ty}, false),
         "acceptMatrixMalloc"
     );
     declareFunction(
-        llvm::FunctionType::get(voidTy, {int32Ty->getPointerTo(), int64Ty, int64Ty, int64Ty, int32Ty}, false),
+        llvm::FunctionType::get(voidTy, {int64Ty->getPointerTo(), int64Ty, int64Ty, int64Ty, int32Ty}, false),
         "acceptArraySet"
     );
     declareFunction(
-        llvm::FunctionType::get(voidTy, {int32Ty->getPointerTo()}, false),
+        llvm::FunctionType::get(voidTy, {int64Ty->getPointerTo()}, false),
         "acceptMatrixFree"
     );
 
+    // Thread pool
+    llvm::FunctionType *threadPoolTaskTy = llvm::FunctionType::get(voidTy, { int8Ty->getPointerTo(), int64Ty, int64Ty }, false);
+    declareFunction(
+        llvm::FunctionType::get(voidTy, { int64Ty, int64Ty, int64Ty, threadPoolTaskTy->getPointerTo(), int8Ty->getPointerTo() }, false),
+        "threadPoolParallelFor"
+    );
+
     declareFunction(
         llvm::FunctionType::get(voidTy, {runtimeVariableTy->getPointerTo(), int8Ty}, false),
         "variableSetIsBlockScoped"
@@ -322,6 +395,10 @@ void LLVMIRFunction::declareAllFunctions() {
         llvm::FunctionType::get(voidTy, {runtimeStackTy->getPointerTo()}, false), 
         "runtimeStackDestructThenFree"
     );
+    declareFunction(
+        llvm::FunctionType::get(runtimeStackTy->getPointerTo(), {}, false),
+        "runtimeStackGetThreadLocal"
+    );
     declareFunction(
         llvm::FunctionType::get(runtimeVariableTy->getPointerTo(), {runtimeStackTy->getPointerTo()}, false),
         "variableStackAllocate"
@@ -11,12 +11,16 @@
 #include "RefWalk.h"
 #include "TypeWalk.h"
 #include "LLVMGen.h"
+#include "CodegenOptions.h"
 #include "TypePromote.h"
 #include "DiagnosticErrorListener.h"
 #include "BailErrorStrategy.h"
 #include "exceptions.h"
 #include <iostream>
 #include <fstream>
+#include <vector>
+#include <map>
+#include <string>
 
 class MyErrorListener : public antlr4::BaseErrorListener {
 
@@ -28,15 +32,70 @@ class MyErrorListener : public antlr4::BaseErrorListener {
 };
 
 int main(int argc, char **argv) {
-  if (argc < 3) {
+  // Separate the options from the positional arguments
+  gazprea::CodegenOptions options;
+#ifdef GAZRT_STATIC_LIB
+  options.runtimeLibraryPath = GAZRT_STATIC_LIB;
+#endif
+#ifdef GAZRT_SHARED_LIB
+  options.runtimeSharedLibraryPath = GAZRT_SHARED_LIB;
+#endif
+#ifdef GAZRT_BITCODE
+  options.runtimeBitcodePath = GAZRT_BITCODE;
+#endif
+  const std::map<std::string, gazprea::EmitKind> emitKinds = {
+    {"ll", gazprea::EmitKind::LLVM_IR},
+    {"bc", gazprea::EmitKind::BITCODE},
+    {"asm", gazprea::EmitKind::ASSEMBLY},
+    {"obj", gazprea::EmitKind::OBJECT},
+    {"exe", gazprea::EmitKind::EXECUTABLE},
+  };
+  std::vector<std::string> positionalArgs;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg.size() == 3 && arg.rfind("-O", 0) == 0 && arg[2] >= '0' && arg[2] <= '3') {
+      options.optLevel = arg[2] - '0';
+    } else if (arg.rfind("--emit=", 0) == 0 && emitKinds.count(arg.substr(7)) != 0) {
+      options.emitKind = emitKinds.at(arg.substr(7));
+    } else if (arg.rfind("--gazrt=", 0) == 0) {
+      options.runtimeLibraryPath = arg.substr(8);
+    } else if (arg == "--run") {
+      options.runJIT = true;
+    } else if (arg.rfind("--gazrt-shared=", 0) == 0) {
+      options.runtimeSharedLibraryPath = arg.substr(15);
+    } else if (arg == "--link-gazrt-bc") {
+      options.linkRuntimeBitcode = true;
+    } else if (arg.rfind("--gazrt-bc=", 0) == 0) {
+      options.linkRuntimeBitcode = true;
+      options.runtimeBitcodePath = arg.substr(11);
+    } else if (arg == "--parallel-comprehensions") {
+      options.parallelComprehensions = true;
+    } else if (arg.rfind("-", 0) == 0 && arg.size() > 1) {
+      std::cout << "Unknown option " << arg << "\n";
+      return 1;
+    } else {
+      positionalArgs.push_back(arg);
+    }
+  }
+
+  if (positionalArgs.size() < (options.runJIT ? 1u : 2u)) {
     std::cout << "Missing required argument.\n"
-              << "Required arguments: <input file path> <output file path>\n";
+              << "Required arguments: <input file path> <output file path>\n"
+              << "                    <input file path> with --run\n"
+              << "Options: -O0 | -O1 | -O2 | -O3 (default -O0)\n"
+              << "         --emit=ll|bc|asm|obj|exe (default ll)\n"
+              << "         --gazrt=<path to libgazrt.a> (static runtime linked by --emit=exe)\n"
+              << "         --run (compile main with a JIT and run it instead of writing the output file)\n"
+              << "         --gazrt-shared=<path to libgazrt.so> (shared runtime loaded by --run)\n"
+              << "         --link-gazrt-bc (link the runtime bitcode into the module so it can be inlined)\n"
+              << "         --gazrt-bc=<path to gazrt.bc> (runtime bitcode, implies --link-gazrt-bc)\n"
+              << "         --parallel-comprehensions (run generators/filters with pure scalar bodies on all cores)\n";
     return 1;
   }
 
   // Open the file then parse and lex it.
   antlr4::ANTLRFileStream afs;
-  afs.loadFromFile(argv[1]);
+  afs.loadFromFile(positionalArgs[0]);
   gazprea::GazpreaLexer lexer(&afs);
   antlr4::CommonTokenStream tokens(&lexer);
   gazprea::GazpreaParser parser(&tokens);
@@ -54,7 +113,7 @@ int main(int argc, char **argv) {
   auto ast = std::any_cast<std::shared_ptr<gazprea::AST>>(builder.visit(tree));
 
   // Initialize the symbol table
-  std::string outfile(argv[2]);
+  std::string outfile(positionalArgs.size() > 1 ? positionalArgs[1] : "");
   auto symtab = std::make_shared<gazprea::SymbolTable>();
 
   gazprea::DefWalk defwalk(symtab);
@@ -71,7 +130,7 @@ int main(int argc, char **argv) {
   gazprea::TypeWalk typewalk(symtab, tp);
   typewalk.visit(ast);
 
-  gazprea::LLVMGen llvmgen(symtab, tp, outfile);
+  gazprea::LLVMGen llvmgen(symtab, tp, outfile, options);
   llvmgen.visit(ast);
 
   return 0;
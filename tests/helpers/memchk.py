@@ -57,6 +57,8 @@ def main():
             # to .ll
             llFile = "../gazprea_program.ll"
             args = [root_path + "bin/gazc", test_path, llFile]
+            if "-parallel" in sys.argv:
+                args.insert(1, "--parallel-comprehensions")
             if "-gazc" in sys.argv:
                 args.insert(0, "valgrind")
             run_program(args)